@@ -1,23 +1,13 @@
 #include "stdafx.h"
 #include "audio.h"
+#include "audio_backend.h"
 #include "pool.h"
 #include "console.h"
 
-#include <fmod/fmod_studio.h>
-
-#ifdef _DEBUG
-#pragma comment(lib, "fmodL_vc.lib")
-#pragma comment(lib, "fmodstudioL_vc.lib")
-#else
-#pragma comment(lib, "fmod_vc.lib")
-#pragma comment(lib, "fmodstudio_vc.lib")
-#endif
-
 namespace audio {
 	const std::string BUS_MASTER = "bus:/";
 	const std::string BUS_SOUND = "bus:/sound";
 	const std::string BUS_MUSIC = "bus:/music";
-	const float _PIXELS_PER_FMOD_UNIT = 16.f;
 
 	bool log_errors =
 #ifdef _DEBUG
@@ -26,14 +16,67 @@ namespace audio {
 		false;
 #endif
 
+	// HACK: FMOD doesn't let us query which bus an event is routed to, so for the
+	// instance caps we put events into voice buses based on their path instead.
+	enum class _VoiceBus {
+		Sound,
+		Music,
+		Count,
+	};
+
+	const int _MAX_INSTANCES_PER_VOICE_BUS[(size_t)_VoiceBus::Count] = {
+		64, // Sound
+		4,  // Music
+	};
+
+	struct EventInfo {
+		BackendEventDescription* desc = nullptr;
+		_VoiceBus voice_bus = _VoiceBus::Sound;
+		bool is_3d = false;
+		float max_distance = 0.f; // in pixels, 0 = unlimited
+		int instance_count = 0; // number of live instances that count towards the caps
+	};
+
 	struct Event {
-		FMOD_STUDIO_EVENTINSTANCE* instance = nullptr;
+		BackendEventInstance* instance = nullptr; // nullptr = freed
+		Handle<Event> handle;
+		EventInfo* info = nullptr;
+		int priority = 0;
+		Vector2f position;
+		bool counted = false; // whether the event counts towards the instance caps
 	};
 
-	FMOD_STUDIO_SYSTEM* _system = nullptr;
-	FMOD_STUDIO_EVENTINSTANCE* _event_buffer[1024] = {};
+	const Backend* _backend = nullptr;
+	BackendType _backend_type = BackendType::Fmod;
+	std::vector<std::string> _bank_paths; // reloaded when switching backends
 	Pool<Event> _event_pool;
-	std::unordered_set<std::string> _events_played_this_frame;
+	std::unordered_map<EventId, EventInfo> _event_infos; // node-based, so Event::info stays valid
+	int _voice_bus_instance_counts[(size_t)_VoiceBus::Count] = {};
+	Vector2f _listener_position;
+	unsigned int _events_spawned = 0;
+	unsigned int _events_culled = 0;
+	unsigned int _events_stolen = 0;
+
+	// An open-addressed set of the events created this frame, used to avoid creating
+	// the same event several times in one frame. It is cleared in update().
+	EventId _events_played_this_frame[256] = {};
+	size_t _events_played_this_frame_count = 0;
+
+	// Returns false if the event was already played this frame.
+	bool _insert_event_played_this_frame(EventId id) {
+		// PITFALL: Keep the load factor low so that probing stays short. If there are
+		// ever this many distinct events in a frame, we simply stop deduplicating.
+		if (_events_played_this_frame_count >= _countof(_events_played_this_frame) / 2) return true;
+		const size_t mask = _countof(_events_played_this_frame) - 1;
+		for (size_t i = (size_t)id & mask;; i = (i + 1) & mask) {
+			if (_events_played_this_frame[i] == id) return false;
+			if (_events_played_this_frame[i] == EventId::None) {
+				_events_played_this_frame[i] = id;
+				++_events_played_this_frame_count;
+				return true;
+			}
+		}
+	}
 
 	void* _event_handle_to_userdata(Handle<Event> handle) {
 		uint32_t uint = *(uint32_t*)&handle;
@@ -45,118 +88,156 @@ namespace audio {
 		return *(Handle<Event>*) & uint;
 	}
 
-	FMOD_RESULT F_CALLBACK _fmod_callback_on_event_destroyed(
-		FMOD_STUDIO_EVENT_CALLBACK_TYPE type,
-		FMOD_STUDIO_EVENTINSTANCE* instance,
-		void* parameters) {
-		void* userdata = nullptr;
-		FMOD_Studio_EventInstance_GetUserData(instance, &userdata);
-		if (!userdata) return FMOD_OK;
-		_event_pool.free(_userdata_to_event_handle(userdata));
-		return FMOD_OK;
+	void _uncount_event(Event& ev) {
+		if (!ev.counted) return;
+		ev.counted = false;
+		ev.info->instance_count--;
+		_voice_bus_instance_counts[(size_t)ev.info->voice_bus]--;
+	}
+
+	void _free_event(Event& ev) {
+		_uncount_event(ev);
+		ev.instance = nullptr;
+		_event_pool.free(ev.handle);
 	}
 
-	FMOD_STUDIO_BUS* _get_bus(const std::string& path) {
-		FMOD_STUDIO_BUS* bus = nullptr;
-		FMOD_RESULT result = FMOD_Studio_System_GetBus(_system, path.c_str(), &bus);
-		if (result != FMOD_OK && log_errors) {
+	void _on_event_destroyed(void* userdata) {
+		if (Event* ev = _event_pool.get(_userdata_to_event_handle(userdata))) {
+			_free_event(*ev);
+		}
+	}
+
+	BackendBus* _get_bus(const std::string& path) {
+		BackendBus* bus = _backend->find_bus(path.c_str());
+		if (!bus && log_errors) {
 			console::log_error("Could not find audio bus: " + path);
 		}
 		return bus;
 	}
 
-	FMOD_STUDIO_EVENTDESCRIPTION* _get_event_description(const char* path) {
-		FMOD_STUDIO_EVENTDESCRIPTION* desc = nullptr;
-		FMOD_RESULT result = FMOD_Studio_System_GetEvent(_system, path, &desc);
-		if (result != FMOD_OK && log_errors) {
-			console::log_error("Could not find audio event: " + std::string(path));
+	EventInfo _make_event_info(BackendEventDescription* desc, std::string_view path) {
+		EventInfo info{ .desc = desc };
+		if (path.starts_with("event:/music/") || path.starts_with("event:/mus_")) {
+			info.voice_bus = _VoiceBus::Music;
+		}
+		info.is_3d = _backend->is_event_3d(desc);
+		if (info.is_3d) {
+			info.max_distance = _backend->get_event_max_distance(desc);
 		}
-		return desc;
+		return info;
 	}
 
-	FMOD_STUDIO_EVENTINSTANCE* _create_event_instance(FMOD_STUDIO_EVENTDESCRIPTION* desc) {
-		FMOD_STUDIO_EVENTINSTANCE* instance = nullptr;
-		FMOD_RESULT result = FMOD_Studio_EventDescription_CreateInstance(desc, &instance);
-		if (result != FMOD_OK && log_errors) {
-			console::log_error("Failed to create audio event");
+	void _cache_event_description(BackendEventDescription* desc, const char* path) {
+		auto [it, inserted] = _event_infos.try_emplace(get_event_id(path), _make_event_info(desc, path));
+		if (!inserted && it->second.desc != desc && log_errors) {
+			console::log_error("Audio event ID collision: " + std::string(path));
 		}
-		return instance;
 	}
 
-	// The returned span is valid only until the next call to _get_event_instances.
-	std::span<FMOD_STUDIO_EVENTINSTANCE*> _get_event_instances(FMOD_STUDIO_EVENTDESCRIPTION* desc) {
-		int count = 0;
-		FMOD_Studio_EventDescription_GetInstanceList(desc, _event_buffer, _countof(_event_buffer), &count);
-		return std::span(_event_buffer, count);
+	// Looks up a cached event description. The path is only used as a fallback
+	// for events that aren't cached, e.g. when given as a GUID string.
+	EventInfo* _find_event_info(EventId id, const std::string& path = {}) {
+		if (id == EventId::None) return nullptr;
+		if (auto it = _event_infos.find(id); it != _event_infos.end()) {
+			return &it->second;
+		}
+		if (!path.empty()) {
+			BackendEventDescription* desc = _backend->find_event(path.c_str());
+			if (!desc) {
+				if (log_errors) {
+					console::log_error("Could not find audio event: " + path);
+				}
+				return nullptr;
+			}
+			return &_event_infos.try_emplace(id, _make_event_info(desc, path)).first->second;
+		}
+		if (log_errors) {
+			console::log_error("Could not find audio event with ID: " + std::to_string((uint32_t)id));
+		}
+		return nullptr;
 	}
 
-	FMOD_STUDIO_EVENTINSTANCE* _get_event_instance(Handle<Event> handle) {
+	BackendEventInstance* _get_event_instance(Handle<Event> handle) {
 		Event* ev = _event_pool.get(handle);
 		if (!ev) return nullptr;
 		return ev->instance;
 	}
 
-	void initialize() {
-		FMOD_RESULT result = FMOD_Studio_System_Create(&_system, FMOD_VERSION);
-		assert(result == FMOD_OK);
-		FMOD_STUDIO_INITFLAGS flags = FMOD_STUDIO_INIT_LIVEUPDATE;
-#ifdef _DEBUG
-		flags |= FMOD_STUDIO_INIT_LIVEUPDATE;
-#endif
-		result = FMOD_Studio_System_Initialize(
-			_system,
-			512, // max channels
-			flags,
-			FMOD_INIT_NORMAL,
-			nullptr);
-		assert(result == FMOD_OK);
+	void initialize(BackendType backend_type) {
+		_backend_type = backend_type;
+		_backend = (backend_type == BackendType::Mock) ? &mock_backend : &fmod_backend;
+		_backend->initialize(_on_event_destroyed);
 	}
 
 	void shutdown() {
-		FMOD_Studio_System_Release(_system);
-		_system = nullptr;
+		// The instances die with the backend, so we free their events here instead of in the destroyed callback.
+		for (Event& ev : _event_pool.span()) {
+			if (ev.instance) {
+				_free_event(ev);
+			}
+		}
+		_event_infos.clear();
+		std::fill_n(_events_played_this_frame, _countof(_events_played_this_frame), EventId::None);
+		_events_played_this_frame_count = 0;
+		_backend->shutdown();
+		_backend = nullptr;
 	}
 
 	void update() {
-		FMOD_Studio_System_Update(_system);
-		_events_played_this_frame.clear();
+		_backend->update();
+		std::fill_n(_events_played_this_frame, _countof(_events_played_this_frame), EventId::None);
+		_events_played_this_frame_count = 0;
 	}
 
 	void load_bank_from_file(const std::string& path) {
-		FMOD_STUDIO_BANK* bank = nullptr;
-		FMOD_RESULT result = FMOD_Studio_System_LoadBankFile(
-			_system, path.c_str(), FMOD_STUDIO_LOAD_BANK_NORMAL, &bank);
-		if (result != FMOD_OK && log_errors) {
-			console::log_error("Failed to load audio bank: " + path);
+		if (std::find(_bank_paths.begin(), _bank_paths.end(), path) == _bank_paths.end()) {
+			_bank_paths.push_back(path);
+		}
+		if (!_backend->load_bank(path.c_str())) {
+			if (log_errors) {
+				console::log_error("Failed to load audio bank: " + path);
+			}
+			return;
 		}
+		// Event paths are only available once the strings bank is loaded,
+		// so we recache the events of all loaded banks every time a bank is loaded.
+		_backend->for_each_event(_cache_event_description);
 	}
 
-	FMOD_3D_ATTRIBUTES _pos_to_3d_attributes(const Vector2f& position) {
-		FMOD_3D_ATTRIBUTES attributes{};
-		attributes.position = { position.x / _PIXELS_PER_FMOD_UNIT, -position.y / _PIXELS_PER_FMOD_UNIT, 0.f };
-		attributes.forward = { 0.f, 0.f, 1.f };
-		attributes.up = { 0.f, 1.f, 0.f };
-		return attributes;
+	void set_backend(BackendType backend_type) {
+		if (!_backend || backend_type == _backend_type) return;
+		const std::string* buses[] = { &BUS_MASTER, &BUS_SOUND, &BUS_MUSIC };
+		float bus_volumes[_countof(buses)] = {};
+		for (size_t i = 0; i < _countof(buses); ++i) {
+			get_bus_volume(*buses[i], bus_volumes[i]);
+		}
+		const Vector2f listener_position = _listener_position;
+		shutdown();
+		initialize(backend_type);
+		for (const std::string& path : std::vector<std::string>(_bank_paths)) {
+			load_bank_from_file(path);
+		}
+		for (size_t i = 0; i < _countof(buses); ++i) {
+			set_bus_volume(*buses[i], bus_volumes[i]);
+		}
+		set_listener_position(listener_position);
 	}
 
-	Vector2f _3d_attributes_to_pos(const FMOD_3D_ATTRIBUTES& attributes) {
-		return { attributes.position.x * _PIXELS_PER_FMOD_UNIT, -attributes.position.y * _PIXELS_PER_FMOD_UNIT };
+	BackendType get_backend_type() {
+		return _backend_type;
 	}
 
 	void set_listener_position(const Vector2f& position) {
-		FMOD_3D_ATTRIBUTES attributes = _pos_to_3d_attributes(position);
-		FMOD_Studio_System_SetListenerAttributes(_system, 0, &attributes, nullptr);
+		_listener_position = position;
+		_backend->set_listener_position(position);
 	}
 
 	Vector2f get_listener_position() {
-		FMOD_3D_ATTRIBUTES attributes{};
-		FMOD_Studio_System_GetListenerAttributes(_system, 0, &attributes, nullptr);
-		return _3d_attributes_to_pos(attributes);
+		return _backend->get_listener_position();
 	}
 
 	bool set_parameter(const std::string& name, float value) {
-		FMOD_RESULT result = FMOD_Studio_System_SetParameterByName(_system, name.c_str(), value, false);
-		if (result == FMOD_OK) return true;
+		if (_backend->set_parameter(name.c_str(), value)) return true;
 		if (log_errors) {
 			console::log_error("Could not find audio parameter: " + name + "=" + std::to_string(value));
 		}
@@ -164,8 +245,7 @@ namespace audio {
 	}
 
 	bool get_parameter(const std::string& name, float& value) {
-		FMOD_RESULT result = FMOD_Studio_System_GetParameterByName(_system, name.c_str(), &value, nullptr);
-		if (result == FMOD_OK) return true;
+		if (_backend->get_parameter(name.c_str(), value)) return true;
 		if (log_errors) {
 			console::log_error("Could not find audio parameter: " + name);
 		}
@@ -173,8 +253,7 @@ namespace audio {
 	}
 
 	bool set_parameter_label(const std::string& name, const std::string& label) {
-		FMOD_RESULT result = FMOD_Studio_System_SetParameterByName(_system, name.c_str(), 0.f, false);
-		if (result == FMOD_OK) return true;
+		if (_backend->set_parameter(name.c_str(), 0.f)) return true;
 		if (log_errors) {
 			console::log_error("Could not find audio parameter label: " + name + "=" + label);
 		}
@@ -183,17 +262,14 @@ namespace audio {
 
 	bool get_parameter_label(const std::string& name, std::string& label) {
 		float value = 0.f;
-		FMOD_RESULT result = FMOD_Studio_System_GetParameterByName(_system, name.c_str(), &value, nullptr);
-		if (result != FMOD_OK) {
+		if (!_backend->get_parameter(name.c_str(), value)) {
 			if (log_errors) {
 				console::log_error("Could not find audio parameter: " + name);
 			}
 			return false;
 		}
-		char label_buffer[256];
-		result = FMOD_Studio_System_GetParameterLabelByName(
-			_system, name.c_str(), (int)value, label_buffer, _countof(label_buffer), nullptr);
-		if (result != FMOD_OK) {
+		char label_buffer[256] = {};
+		if (!_backend->get_parameter_label(name.c_str(), (int)value, label_buffer, _countof(label_buffer))) {
 			if (log_errors) {
 				console::log_error("Could not get parameter label: " + name + "=" + std::to_string(value));
 			}
@@ -202,97 +278,177 @@ namespace audio {
 		return true;
 	}
 
+	bool is_any_playing(EventId event_id) {
+		EventInfo* info = _find_event_info(event_id);
+		return info && _backend->is_any_instance_playing(info->desc);
+	}
+
 	bool is_any_playing(const std::string& event_path) {
-		if (event_path.empty()) return false;
-		FMOD_STUDIO_EVENTDESCRIPTION* desc = _get_event_description(event_path.c_str());
-		if (!desc) return false;
-		for (FMOD_STUDIO_EVENTINSTANCE* instance : _get_event_instances(desc)) {
-			FMOD_STUDIO_PLAYBACK_STATE state;
-			FMOD_Studio_EventInstance_GetPlaybackState(instance, &state);
-			if (state == FMOD_STUDIO_PLAYBACK_PLAYING) return true;
+		EventInfo* info = _find_event_info(get_event_id(event_path), event_path);
+		return info && _backend->is_any_instance_playing(info->desc);
+	}
+
+	float _get_distance_squared_to_listener(const EventInfo& info, const Vector2f& position) {
+		if (!info.is_3d) return 0.f;
+		return length_squared(position - _listener_position);
+	}
+
+	// Finds the least important live event that belongs to the same event (if same_event is true)
+	// or the same voice bus as the given info. Events are ranked by priority, then by distance to the listener.
+	Event* _find_event_to_steal(const EventInfo& info, bool same_event) {
+		Event* victim = nullptr;
+		float victim_distance_squared = 0.f;
+		for (Event& ev : _event_pool.span()) {
+			if (!ev.counted) continue;
+			if (same_event ? (ev.info != &info) : (ev.info->voice_bus != info.voice_bus)) continue;
+			const float distance_squared = _get_distance_squared_to_listener(*ev.info, ev.position);
+			if (!victim || ev.priority < victim->priority ||
+				(ev.priority == victim->priority && distance_squared > victim_distance_squared)) {
+				victim = &ev;
+				victim_distance_squared = distance_squared;
+			}
 		}
-		return false;
+		return victim;
+	}
+
+	// Makes room for a new event if its instance cap is reached. Returns false if the
+	// new event is less important than all the events it could steal from.
+	bool _make_room_for_event(const EventInfo& info, bool same_event, int priority, float distance_squared) {
+		Event* victim = _find_event_to_steal(info, same_event);
+		if (!victim) return false;
+		if (victim->priority > priority) return false;
+		if (victim->priority == priority &&
+			_get_distance_squared_to_listener(*victim->info, victim->position) < distance_squared) return false;
+		_backend->stop_instance(victim->instance);
+		_uncount_event(*victim);
+		_events_stolen++;
+		return true;
 	}
 
 	Handle<Event> create_event(const EventDesc&& desc) {
-		if (desc.path.empty()) return Handle<Event>();
-		if (_events_played_this_frame.contains(desc.path)) return Handle<Event>();
-		FMOD_STUDIO_EVENTDESCRIPTION* studio_desc = _get_event_description(desc.path.c_str());
-		if (!studio_desc) return Handle<Event>();
-		FMOD_STUDIO_EVENTINSTANCE* instance = _create_event_instance(studio_desc);
-		if (!instance) return Handle<Event>();
-		Handle<Event> handle = _event_pool.emplace(Event{ .instance = instance });
-		_events_played_this_frame.insert(desc.path);
-		FMOD_Studio_EventInstance_SetCallback(instance, _fmod_callback_on_event_destroyed, FMOD_STUDIO_EVENT_CALLBACK_DESTROYED);
-		FMOD_Studio_EventInstance_SetUserData(instance, _event_handle_to_userdata(handle));
-		FMOD_Studio_EventInstance_SetVolume(instance, desc.volume);
-		FMOD_3D_ATTRIBUTES attributes = _pos_to_3d_attributes(desc.position);
-		FMOD_Studio_EventInstance_Set3DAttributes(instance, &attributes);
+		const EventId id = (desc.id != EventId::None) ? desc.id : get_event_id(desc.path);
+		if (id == EventId::None) return Handle<Event>();
+		EventInfo* info = _find_event_info(id, desc.path);
+		if (!info) return Handle<Event>();
+
+		// Cull spatial events that are too far away to be heard before the backend ever sees them.
+		const float distance_squared = _get_distance_squared_to_listener(*info, desc.position);
+		if (info->max_distance > 0.f && distance_squared > info->max_distance * info->max_distance) {
+			_events_culled++;
+			return Handle<Event>();
+		}
+		if (!_insert_event_played_this_frame(id)) return Handle<Event>();
+
+		// Enforce the instance caps, stealing voices from less important events if necessary.
+		if (info->instance_count >= desc.max_instances &&
+			!_make_room_for_event(*info, true, desc.priority, distance_squared)) {
+			_events_culled++;
+			return Handle<Event>();
+		}
+		if (_voice_bus_instance_counts[(size_t)info->voice_bus] >= _MAX_INSTANCES_PER_VOICE_BUS[(size_t)info->voice_bus] &&
+			!_make_room_for_event(*info, false, desc.priority, distance_squared)) {
+			_events_culled++;
+			return Handle<Event>();
+		}
+
+		Handle<Event> handle = _event_pool.emplace();
+		BackendEventInstance* instance = _backend->create_instance(info->desc, _event_handle_to_userdata(handle));
+		if (!instance) {
+			if (log_errors) {
+				console::log_error("Failed to create audio event");
+			}
+			_event_pool.free(handle);
+			return Handle<Event>();
+		}
+		*_event_pool.get(handle) = Event{
+			.instance = instance,
+			.handle = handle,
+			.info = info,
+			.priority = desc.priority,
+			.position = desc.position,
+			.counted = true };
+		info->instance_count++;
+		_voice_bus_instance_counts[(size_t)info->voice_bus]++;
+		_events_spawned++;
+		_backend->set_instance_volume(instance, desc.volume);
+		_backend->set_instance_position(instance, desc.position);
 		if (desc.start) {
-			FMOD_Studio_EventInstance_Start(instance);
+			_backend->start_instance(instance);
 		}
 		if (desc.release) {
-			FMOD_Studio_EventInstance_Release(instance);
+			_backend->release_instance(instance);
 		}
 		return handle;
 	}
 
 	bool stop_event(Handle<Event> handle) {
-		FMOD_STUDIO_EVENTINSTANCE* instance = _get_event_instance(handle);
+		BackendEventInstance* instance = _get_event_instance(handle);
 		if (!instance) return false;
-		FMOD_Studio_EventInstance_Stop(instance, FMOD_STUDIO_STOP_IMMEDIATE);
+		_backend->stop_instance(instance);
 		return true;
 	}
 
 	bool set_event_volume(Handle<Event> handle, float volume) {
-		FMOD_STUDIO_EVENTINSTANCE* instance = _get_event_instance(handle);
+		BackendEventInstance* instance = _get_event_instance(handle);
 		if (!instance) return false;
-		FMOD_Studio_EventInstance_SetVolume(instance, volume);
+		_backend->set_instance_volume(instance, volume);
 		return true;
 	}
 
 	bool get_event_volume(Handle<Event> handle, float& volume) {
-		FMOD_STUDIO_EVENTINSTANCE* instance = _get_event_instance(handle);
+		BackendEventInstance* instance = _get_event_instance(handle);
 		if (!instance) return false;
-		FMOD_Studio_EventInstance_GetVolume(instance, &volume, nullptr);
+		volume = _backend->get_instance_volume(instance);
 		return true;
 	}
 
 	bool set_event_position(Handle<Event> handle, const Vector2f& position) {
-		FMOD_STUDIO_EVENTINSTANCE* instance = _get_event_instance(handle);
-		if (!instance) return false;
-		FMOD_3D_ATTRIBUTES attributes = _pos_to_3d_attributes(position);
-		FMOD_Studio_EventInstance_Set3DAttributes(instance, &attributes);
+		Event* ev = _event_pool.get(handle);
+		if (!ev || !ev->instance) return false;
+		ev->position = position;
+		_backend->set_instance_position(ev->instance, position);
 		return true;
 	}
 
 	bool get_event_position(Handle<Event> handle, Vector2f& position) {
-		FMOD_STUDIO_EVENTINSTANCE* instance = _get_event_instance(handle);
+		BackendEventInstance* instance = _get_event_instance(handle);
 		if (!instance) return false;
-		FMOD_3D_ATTRIBUTES attributes{};
-		FMOD_Studio_EventInstance_Get3DAttributes(instance, &attributes);
-		position = _3d_attributes_to_pos(attributes);
+		position = _backend->get_instance_position(instance);
 		return true;
 	}
 
 	bool set_bus_volume(const std::string& bus_path, float volume) {
-		FMOD_STUDIO_BUS* bus = _get_bus(bus_path);
+		BackendBus* bus = _get_bus(bus_path);
 		if (!bus) return false;
-		FMOD_Studio_Bus_SetVolume(bus, volume);
+		_backend->set_bus_volume(bus, volume);
 		return true;
 	}
 
 	bool get_bus_volume(const std::string& bus_path, float& volume) {
-		FMOD_STUDIO_BUS* bus = _get_bus(bus_path);
+		BackendBus* bus = _get_bus(bus_path);
 		if (!bus) return false;
-		FMOD_Studio_Bus_GetVolume(bus, &volume, nullptr);
+		volume = _backend->get_bus_volume(bus);
 		return true;
 	}
 
 	bool stop_all_in_bus(const std::string& bus_path) {
-		FMOD_STUDIO_BUS* bus = _get_bus(bus_path);
+		BackendBus* bus = _get_bus(bus_path);
 		if (!bus) return false;
-		FMOD_Studio_Bus_StopAllEvents(bus, FMOD_STUDIO_STOP_IMMEDIATE);
+		_backend->stop_all_in_bus(bus);
 		return true;
 	}
-}
+
+	// STATS
+
+	unsigned int get_events_spawned() {
+		return _events_spawned;
+	}
+
+	unsigned int get_events_culled() {
+		return _events_culled;
+	}
+
+	unsigned int get_events_stolen() {
+		return _events_stolen;
+	}
+}
\ No newline at end of file
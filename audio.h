@@ -10,11 +10,21 @@ namespace audio
 
 	extern bool log_errors;
 
-	void initialize();
+	enum class BackendType {
+		Fmod, // FMOD Studio
+		Mock, // Plays nothing; simulates event lifetimes and buses in-process. See audio_backend.h.
+	};
+
+	void initialize(BackendType backend_type = BackendType::Fmod);
 	void shutdown();
 	void update();
 	void load_bank_from_file(const std::string& path);
 
+	// Shuts down the current backend and initializes the given one, reloading all banks and keeping
+	// the listener position and the volumes of the standard buses. Live events are not carried over.
+	void set_backend(BackendType backend_type);
+	BackendType get_backend_type();
+
 	// LISTENERS
 
 	void set_listener_position(const Vector2f& position);
@@ -29,14 +39,32 @@ namespace audio
 
 	// EVENTS
 
+	// An event ID is a hash of an event path. When a bank is loaded, the descriptions of its events
+	// are cached by ID, so events can be created from an ID without any string lookups.
+	enum class EventId : uint32_t { None = 0 };
+
+	constexpr EventId get_event_id(std::string_view event_path) {
+		if (event_path.empty()) return EventId::None;
+		uint32_t hash = 2166136261u; // FNV-1a
+		for (char c : event_path) {
+			hash ^= (uint8_t)c;
+			hash *= 16777619u;
+		}
+		return (EventId)(hash ? hash : 1);
+	}
+
+	bool is_any_playing(EventId event_id);
 	bool is_any_playing(const std::string &event_path);
 
 	struct EventDesc {
 		std::string path;
+		EventId id = EventId::None; // if set, takes precedence over the path
 		float volume = 1.f;
 		Vector2f position;
 		bool start = true;
 		bool release = true;
+		int priority = 0; // when an instance cap is reached, events may steal from events of lower or equal priority
+		int max_instances = 8; // max number of live instances of this event
 	};
 
 	Handle<Event> create_event(const EventDesc&& desc);
@@ -51,5 +79,13 @@ namespace audio
 	bool set_bus_volume(const std::string& bus_path, float volume);
 	bool get_bus_volume(const std::string& bus_path, float& volume);
 	bool stop_all_in_bus(const std::string& bus_path = BUS_MASTER);
+
+	// STATS
+
+	// The number of events spawned, culled (because they were inaudible or lost out
+	// to more important events) and stolen (stopped to make room for new events).
+	unsigned int get_events_spawned();
+	unsigned int get_events_culled();
+	unsigned int get_events_stolen();
 }
 
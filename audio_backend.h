@@ -0,0 +1,53 @@
+#pragma once
+
+// The audio module talks to the audio runtime through a backend, which is a table of functions.
+// The FMOD backend is the real thing. The mock backend simulates event lifetimes and bus hierarchies
+// in-process, so that the bookkeeping in the audio module can be measured without FMOD or any banks.
+
+namespace audio {
+	struct BackendEventDescription; // opaque
+	struct BackendEventInstance; // opaque
+	struct BackendBus; // opaque
+
+	// Called once an instance has been released and has stopped playing, after which it is invalid.
+	using BackendEventDestroyedCallback = void (*)(void* userdata);
+	using BackendEventCallback = void (*)(BackendEventDescription* desc, const char* path);
+
+	struct Backend {
+		bool (*initialize)(BackendEventDestroyedCallback on_event_destroyed);
+		void (*shutdown)();
+		void (*update)();
+		bool (*load_bank)(const char* path);
+
+		// Calls the callback for every event in the loaded banks whose path is known.
+		void (*for_each_event)(BackendEventCallback callback);
+		BackendEventDescription* (*find_event)(const char* path);
+		bool (*is_event_3d)(BackendEventDescription* desc);
+		float (*get_event_max_distance)(BackendEventDescription* desc); // in pixels
+		bool (*is_any_instance_playing)(BackendEventDescription* desc);
+
+		BackendEventInstance* (*create_instance)(BackendEventDescription* desc, void* userdata);
+		void (*start_instance)(BackendEventInstance* instance);
+		void (*stop_instance)(BackendEventInstance* instance); // stops immediately
+		void (*release_instance)(BackendEventInstance* instance);
+		void (*set_instance_volume)(BackendEventInstance* instance, float volume);
+		float (*get_instance_volume)(BackendEventInstance* instance);
+		void (*set_instance_position)(BackendEventInstance* instance, const Vector2f& position);
+		Vector2f (*get_instance_position)(BackendEventInstance* instance);
+
+		void (*set_listener_position)(const Vector2f& position);
+		Vector2f (*get_listener_position)();
+
+		bool (*set_parameter)(const char* name, float value);
+		bool (*get_parameter)(const char* name, float& value);
+		bool (*get_parameter_label)(const char* name, int value, char* label, int label_size);
+
+		BackendBus* (*find_bus)(const char* path);
+		void (*set_bus_volume)(BackendBus* bus, float volume);
+		float (*get_bus_volume)(BackendBus* bus);
+		void (*stop_all_in_bus)(BackendBus* bus);
+	};
+
+	extern const Backend fmod_backend;
+	extern const Backend mock_backend;
+}
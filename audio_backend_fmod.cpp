@@ -0,0 +1,252 @@
+#include "stdafx.h"
+#include "audio_backend.h"
+
+#include <fmod/fmod_studio.h>
+
+#ifdef _DEBUG
+#pragma comment(lib, "fmodL_vc.lib")
+#pragma comment(lib, "fmodstudioL_vc.lib")
+#else
+#pragma comment(lib, "fmod_vc.lib")
+#pragma comment(lib, "fmodstudio_vc.lib")
+#endif
+
+namespace audio {
+	const float _PIXELS_PER_FMOD_UNIT = 16.f;
+
+	FMOD_STUDIO_SYSTEM* _fmod_system = nullptr;
+	FMOD_STUDIO_EVENTINSTANCE* _fmod_event_buffer[1024] = {};
+	BackendEventDestroyedCallback _fmod_on_event_destroyed = nullptr;
+
+	FMOD_STUDIO_EVENTDESCRIPTION* _fmod_desc(BackendEventDescription* desc) {
+		return (FMOD_STUDIO_EVENTDESCRIPTION*)desc;
+	}
+
+	FMOD_STUDIO_EVENTINSTANCE* _fmod_instance(BackendEventInstance* instance) {
+		return (FMOD_STUDIO_EVENTINSTANCE*)instance;
+	}
+
+	FMOD_STUDIO_BUS* _fmod_bus(BackendBus* bus) {
+		return (FMOD_STUDIO_BUS*)bus;
+	}
+
+	FMOD_3D_ATTRIBUTES _pos_to_3d_attributes(const Vector2f& position) {
+		FMOD_3D_ATTRIBUTES attributes{};
+		attributes.position = { position.x / _PIXELS_PER_FMOD_UNIT, -position.y / _PIXELS_PER_FMOD_UNIT, 0.f };
+		attributes.forward = { 0.f, 0.f, 1.f };
+		attributes.up = { 0.f, 1.f, 0.f };
+		return attributes;
+	}
+
+	Vector2f _3d_attributes_to_pos(const FMOD_3D_ATTRIBUTES& attributes) {
+		return { attributes.position.x * _PIXELS_PER_FMOD_UNIT, -attributes.position.y * _PIXELS_PER_FMOD_UNIT };
+	}
+
+	FMOD_RESULT F_CALLBACK _fmod_callback_on_event_destroyed(
+		FMOD_STUDIO_EVENT_CALLBACK_TYPE type,
+		FMOD_STUDIO_EVENTINSTANCE* instance,
+		void* parameters) {
+		void* userdata = nullptr;
+		FMOD_Studio_EventInstance_GetUserData(instance, &userdata);
+		if (!userdata) return FMOD_OK;
+		_fmod_on_event_destroyed(userdata);
+		return FMOD_OK;
+	}
+
+	bool _fmod_initialize(BackendEventDestroyedCallback on_event_destroyed) {
+		_fmod_on_event_destroyed = on_event_destroyed;
+		FMOD_RESULT result = FMOD_Studio_System_Create(&_fmod_system, FMOD_VERSION);
+		assert(result == FMOD_OK);
+		FMOD_STUDIO_INITFLAGS flags = FMOD_STUDIO_INIT_LIVEUPDATE;
+#ifdef _DEBUG
+		flags |= FMOD_STUDIO_INIT_LIVEUPDATE;
+#endif
+		result = FMOD_Studio_System_Initialize(
+			_fmod_system,
+			512, // max channels
+			flags,
+			FMOD_INIT_NORMAL,
+			nullptr);
+		assert(result == FMOD_OK);
+		return result == FMOD_OK;
+	}
+
+	void _fmod_shutdown() {
+		FMOD_Studio_System_Release(_fmod_system);
+		_fmod_system = nullptr;
+	}
+
+	void _fmod_update() {
+		FMOD_Studio_System_Update(_fmod_system);
+	}
+
+	bool _fmod_load_bank(const char* path) {
+		FMOD_STUDIO_BANK* bank = nullptr;
+		return FMOD_Studio_System_LoadBankFile(
+			_fmod_system, path, FMOD_STUDIO_LOAD_BANK_NORMAL, &bank) == FMOD_OK;
+	}
+
+	void _fmod_for_each_event(BackendEventCallback callback) {
+		int bank_count = 0;
+		FMOD_Studio_System_GetBankCount(_fmod_system, &bank_count);
+		std::vector<FMOD_STUDIO_BANK*> banks(bank_count);
+		FMOD_Studio_System_GetBankList(_fmod_system, banks.data(), bank_count, &bank_count);
+		std::vector<FMOD_STUDIO_EVENTDESCRIPTION*> descs;
+		char path[512];
+		for (FMOD_STUDIO_BANK* bank : banks) {
+			int event_count = 0;
+			FMOD_Studio_Bank_GetEventCount(bank, &event_count);
+			descs.resize(event_count);
+			FMOD_Studio_Bank_GetEventList(bank, descs.data(), event_count, &event_count);
+			for (FMOD_STUDIO_EVENTDESCRIPTION* desc : std::span(descs.data(), event_count)) {
+				if (FMOD_Studio_EventDescription_GetPath(desc, path, _countof(path), nullptr) != FMOD_OK) continue;
+				callback((BackendEventDescription*)desc, path);
+			}
+		}
+	}
+
+	BackendEventDescription* _fmod_find_event(const char* path) {
+		FMOD_STUDIO_EVENTDESCRIPTION* desc = nullptr;
+		FMOD_Studio_System_GetEvent(_fmod_system, path, &desc);
+		return (BackendEventDescription*)desc;
+	}
+
+	bool _fmod_is_event_3d(BackendEventDescription* desc) {
+		FMOD_BOOL is_3d = false;
+		FMOD_Studio_EventDescription_Is3D(_fmod_desc(desc), &is_3d);
+		return is_3d;
+	}
+
+	float _fmod_get_event_max_distance(BackendEventDescription* desc) {
+		float min_distance = 0.f;
+		float max_distance = 0.f;
+		FMOD_Studio_EventDescription_GetMinMaxDistance(_fmod_desc(desc), &min_distance, &max_distance);
+		return max_distance * _PIXELS_PER_FMOD_UNIT;
+	}
+
+	bool _fmod_is_any_instance_playing(BackendEventDescription* desc) {
+		int count = 0;
+		FMOD_Studio_EventDescription_GetInstanceList(
+			_fmod_desc(desc), _fmod_event_buffer, _countof(_fmod_event_buffer), &count);
+		for (FMOD_STUDIO_EVENTINSTANCE* instance : std::span(_fmod_event_buffer, count)) {
+			FMOD_STUDIO_PLAYBACK_STATE state;
+			FMOD_Studio_EventInstance_GetPlaybackState(instance, &state);
+			if (state == FMOD_STUDIO_PLAYBACK_PLAYING) return true;
+		}
+		return false;
+	}
+
+	BackendEventInstance* _fmod_create_instance(BackendEventDescription* desc, void* userdata) {
+		FMOD_STUDIO_EVENTINSTANCE* instance = nullptr;
+		if (FMOD_Studio_EventDescription_CreateInstance(_fmod_desc(desc), &instance) != FMOD_OK) return nullptr;
+		FMOD_Studio_EventInstance_SetCallback(instance, _fmod_callback_on_event_destroyed, FMOD_STUDIO_EVENT_CALLBACK_DESTROYED);
+		FMOD_Studio_EventInstance_SetUserData(instance, userdata);
+		return (BackendEventInstance*)instance;
+	}
+
+	void _fmod_start_instance(BackendEventInstance* instance) {
+		FMOD_Studio_EventInstance_Start(_fmod_instance(instance));
+	}
+
+	void _fmod_stop_instance(BackendEventInstance* instance) {
+		FMOD_Studio_EventInstance_Stop(_fmod_instance(instance), FMOD_STUDIO_STOP_IMMEDIATE);
+	}
+
+	void _fmod_release_instance(BackendEventInstance* instance) {
+		FMOD_Studio_EventInstance_Release(_fmod_instance(instance));
+	}
+
+	void _fmod_set_instance_volume(BackendEventInstance* instance, float volume) {
+		FMOD_Studio_EventInstance_SetVolume(_fmod_instance(instance), volume);
+	}
+
+	float _fmod_get_instance_volume(BackendEventInstance* instance) {
+		float volume = 0.f;
+		FMOD_Studio_EventInstance_GetVolume(_fmod_instance(instance), &volume, nullptr);
+		return volume;
+	}
+
+	void _fmod_set_instance_position(BackendEventInstance* instance, const Vector2f& position) {
+		FMOD_3D_ATTRIBUTES attributes = _pos_to_3d_attributes(position);
+		FMOD_Studio_EventInstance_Set3DAttributes(_fmod_instance(instance), &attributes);
+	}
+
+	Vector2f _fmod_get_instance_position(BackendEventInstance* instance) {
+		FMOD_3D_ATTRIBUTES attributes{};
+		FMOD_Studio_EventInstance_Get3DAttributes(_fmod_instance(instance), &attributes);
+		return _3d_attributes_to_pos(attributes);
+	}
+
+	void _fmod_set_listener_position(const Vector2f& position) {
+		FMOD_3D_ATTRIBUTES attributes = _pos_to_3d_attributes(position);
+		FMOD_Studio_System_SetListenerAttributes(_fmod_system, 0, &attributes, nullptr);
+	}
+
+	Vector2f _fmod_get_listener_position() {
+		FMOD_3D_ATTRIBUTES attributes{};
+		FMOD_Studio_System_GetListenerAttributes(_fmod_system, 0, &attributes, nullptr);
+		return _3d_attributes_to_pos(attributes);
+	}
+
+	bool _fmod_set_parameter(const char* name, float value) {
+		return FMOD_Studio_System_SetParameterByName(_fmod_system, name, value, false) == FMOD_OK;
+	}
+
+	bool _fmod_get_parameter(const char* name, float& value) {
+		return FMOD_Studio_System_GetParameterByName(_fmod_system, name, &value, nullptr) == FMOD_OK;
+	}
+
+	bool _fmod_get_parameter_label(const char* name, int value, char* label, int label_size) {
+		return FMOD_Studio_System_GetParameterLabelByName(
+			_fmod_system, name, value, label, label_size, nullptr) == FMOD_OK;
+	}
+
+	BackendBus* _fmod_find_bus(const char* path) {
+		FMOD_STUDIO_BUS* bus = nullptr;
+		FMOD_Studio_System_GetBus(_fmod_system, path, &bus);
+		return (BackendBus*)bus;
+	}
+
+	void _fmod_set_bus_volume(BackendBus* bus, float volume) {
+		FMOD_Studio_Bus_SetVolume(_fmod_bus(bus), volume);
+	}
+
+	float _fmod_get_bus_volume(BackendBus* bus) {
+		float volume = 0.f;
+		FMOD_Studio_Bus_GetVolume(_fmod_bus(bus), &volume, nullptr);
+		return volume;
+	}
+
+	void _fmod_stop_all_in_bus(BackendBus* bus) {
+		FMOD_Studio_Bus_StopAllEvents(_fmod_bus(bus), FMOD_STUDIO_STOP_IMMEDIATE);
+	}
+
+	const Backend fmod_backend = {
+		.initialize = _fmod_initialize,
+		.shutdown = _fmod_shutdown,
+		.update = _fmod_update,
+		.load_bank = _fmod_load_bank,
+		.for_each_event = _fmod_for_each_event,
+		.find_event = _fmod_find_event,
+		.is_event_3d = _fmod_is_event_3d,
+		.get_event_max_distance = _fmod_get_event_max_distance,
+		.is_any_instance_playing = _fmod_is_any_instance_playing,
+		.create_instance = _fmod_create_instance,
+		.start_instance = _fmod_start_instance,
+		.stop_instance = _fmod_stop_instance,
+		.release_instance = _fmod_release_instance,
+		.set_instance_volume = _fmod_set_instance_volume,
+		.get_instance_volume = _fmod_get_instance_volume,
+		.set_instance_position = _fmod_set_instance_position,
+		.get_instance_position = _fmod_get_instance_position,
+		.set_listener_position = _fmod_set_listener_position,
+		.get_listener_position = _fmod_get_listener_position,
+		.set_parameter = _fmod_set_parameter,
+		.get_parameter = _fmod_get_parameter,
+		.get_parameter_label = _fmod_get_parameter_label,
+		.find_bus = _fmod_find_bus,
+		.set_bus_volume = _fmod_set_bus_volume,
+		.get_bus_volume = _fmod_get_bus_volume,
+		.stop_all_in_bus = _fmod_stop_all_in_bus,
+	};
+}
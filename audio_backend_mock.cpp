@@ -0,0 +1,275 @@
+#include "stdafx.h"
+#include "audio_backend.h"
+#include <deque>
+
+// The mock backend plays nothing. It simulates just enough of FMOD Studio to be deterministic:
+// any event path resolves to an event, one-shot events play for a fixed time, music events loop,
+// released instances are destroyed once they stop, and buses form a hierarchy by path.
+
+namespace audio {
+	const float _MOCK_UPDATE_DT = 1.f / 60.f; // seconds simulated per update
+	const float _MOCK_ONE_SHOT_DURATION = 0.5f; // seconds
+	const float _MOCK_MAX_DISTANCE = 320.f; // pixels
+	const size_t _MOCK_MAX_INSTANCES = 16384;
+	const size_t _MOCK_NO_PARENT = SIZE_MAX;
+
+	struct MockEventDescription {
+		std::string path;
+		size_t bus_index = 0;
+		bool is_3d = false;
+		bool looping = false;
+	};
+
+	struct MockEventInstance {
+		MockEventDescription* desc = nullptr; // nullptr = free
+		void* userdata = nullptr;
+		float volume = 1.f;
+		Vector2f position;
+		float time = 0.f; // seconds since started
+		bool playing = false;
+		bool released = false;
+	};
+
+	struct MockBus {
+		std::string path;
+		size_t parent_index = _MOCK_NO_PARENT;
+		float volume = 1.f;
+	};
+
+	BackendEventDestroyedCallback _mock_on_event_destroyed = nullptr;
+	std::deque<MockEventDescription> _mock_event_descriptions; // deque, so pointers stay valid
+	std::deque<MockBus> _mock_buses; // deque, so pointers stay valid; the master bus comes first
+	std::vector<MockEventInstance> _mock_instances; // never reallocated, so pointers stay valid
+	std::vector<uint32_t> _mock_free_instances;
+	size_t _mock_instance_end = 0; // one past the last instance slot ever used
+	std::unordered_map<std::string, float> _mock_parameters;
+	Vector2f _mock_listener_position;
+
+	size_t _mock_get_bus_index(MockBus* bus) {
+		for (size_t i = 0; i < _mock_buses.size(); ++i) {
+			if (&_mock_buses[i] == bus) return i;
+		}
+		return _mock_buses.size();
+	}
+
+	bool _mock_is_in_bus(size_t bus_index, size_t ancestor_index) {
+		for (; bus_index != _MOCK_NO_PARENT; bus_index = _mock_buses[bus_index].parent_index) {
+			if (bus_index == ancestor_index) return true;
+		}
+		return false;
+	}
+
+	// Returns the index of the bus with the given path, creating it and its ancestors if necessary.
+	size_t _mock_get_or_create_bus(std::string_view path) {
+		for (size_t i = 0; i < _mock_buses.size(); ++i) {
+			if (_mock_buses[i].path == path) return i;
+		}
+		const size_t slash = path.find_last_of('/');
+		if (slash == std::string_view::npos || slash + 1 == path.size()) return 0; // master
+		const std::string_view parent_path = path.substr(0, std::max(slash, path.find('/') + 1));
+		const size_t parent_index = _mock_get_or_create_bus(parent_path);
+		_mock_buses.push_back({ .path = std::string(path), .parent_index = parent_index });
+		return _mock_buses.size() - 1;
+	}
+
+	void _mock_destroy_instance(MockEventInstance& instance) {
+		void* userdata = instance.userdata;
+		instance = {};
+		_mock_free_instances.push_back((uint32_t)(&instance - _mock_instances.data()));
+		if (userdata) {
+			_mock_on_event_destroyed(userdata);
+		}
+	}
+
+	bool _mock_initialize(BackendEventDestroyedCallback on_event_destroyed) {
+		_mock_on_event_destroyed = on_event_destroyed;
+		_mock_buses.push_back({ .path = "bus:/" });
+		_mock_instances.resize(_MOCK_MAX_INSTANCES);
+		_mock_free_instances.reserve(_MOCK_MAX_INSTANCES);
+		for (size_t i = _MOCK_MAX_INSTANCES; i-- > 0;) {
+			_mock_free_instances.push_back((uint32_t)i);
+		}
+		_mock_instance_end = 0;
+		return true;
+	}
+
+	void _mock_shutdown() {
+		_mock_event_descriptions.clear();
+		_mock_buses.clear();
+		_mock_instances.clear();
+		_mock_free_instances.clear();
+		_mock_instance_end = 0;
+		_mock_parameters.clear();
+	}
+
+	void _mock_update() {
+		for (size_t i = 0; i < _mock_instance_end; ++i) {
+			MockEventInstance& instance = _mock_instances[i];
+			if (!instance.desc) continue;
+			if (instance.playing) {
+				instance.time += _MOCK_UPDATE_DT;
+				if (!instance.desc->looping && instance.time >= _MOCK_ONE_SHOT_DURATION) {
+					instance.playing = false;
+				}
+			}
+			if (instance.released && !instance.playing) {
+				_mock_destroy_instance(instance);
+			}
+		}
+	}
+
+	bool _mock_load_bank(const char* path) {
+		return true;
+	}
+
+	void _mock_for_each_event(BackendEventCallback callback) {
+		for (MockEventDescription& desc : _mock_event_descriptions) {
+			callback((BackendEventDescription*)&desc, desc.path.c_str());
+		}
+	}
+
+	BackendEventDescription* _mock_find_event(const char* path) {
+		for (MockEventDescription& desc : _mock_event_descriptions) {
+			if (desc.path == path) return (BackendEventDescription*)&desc;
+		}
+		const std::string_view path_view = path;
+		const bool is_music = path_view.starts_with("event:/music/") || path_view.starts_with("event:/mus_");
+		MockEventDescription& desc = _mock_event_descriptions.emplace_back();
+		desc.path = path;
+		desc.bus_index = _mock_get_or_create_bus(is_music ? "bus:/music" : "bus:/sound");
+		desc.is_3d = !is_music;
+		desc.looping = is_music;
+		return (BackendEventDescription*)&desc;
+	}
+
+	bool _mock_is_event_3d(BackendEventDescription* desc) {
+		return ((MockEventDescription*)desc)->is_3d;
+	}
+
+	float _mock_get_event_max_distance(BackendEventDescription* desc) {
+		return _MOCK_MAX_DISTANCE;
+	}
+
+	bool _mock_is_any_instance_playing(BackendEventDescription* desc) {
+		for (size_t i = 0; i < _mock_instance_end; ++i) {
+			const MockEventInstance& instance = _mock_instances[i];
+			if (instance.desc == (MockEventDescription*)desc && instance.playing) return true;
+		}
+		return false;
+	}
+
+	BackendEventInstance* _mock_create_instance(BackendEventDescription* desc, void* userdata) {
+		if (_mock_free_instances.empty()) return nullptr;
+		const uint32_t index = _mock_free_instances.back();
+		_mock_free_instances.pop_back();
+		_mock_instance_end = std::max(_mock_instance_end, (size_t)index + 1);
+		MockEventInstance& instance = _mock_instances[index];
+		instance.desc = (MockEventDescription*)desc;
+		instance.userdata = userdata;
+		return (BackendEventInstance*)&instance;
+	}
+
+	void _mock_start_instance(BackendEventInstance* instance) {
+		((MockEventInstance*)instance)->playing = true;
+		((MockEventInstance*)instance)->time = 0.f;
+	}
+
+	void _mock_stop_instance(BackendEventInstance* instance) {
+		((MockEventInstance*)instance)->playing = false;
+	}
+
+	void _mock_release_instance(BackendEventInstance* instance) {
+		((MockEventInstance*)instance)->released = true;
+	}
+
+	void _mock_set_instance_volume(BackendEventInstance* instance, float volume) {
+		((MockEventInstance*)instance)->volume = volume;
+	}
+
+	float _mock_get_instance_volume(BackendEventInstance* instance) {
+		return ((MockEventInstance*)instance)->volume;
+	}
+
+	void _mock_set_instance_position(BackendEventInstance* instance, const Vector2f& position) {
+		((MockEventInstance*)instance)->position = position;
+	}
+
+	Vector2f _mock_get_instance_position(BackendEventInstance* instance) {
+		return ((MockEventInstance*)instance)->position;
+	}
+
+	void _mock_set_listener_position(const Vector2f& position) {
+		_mock_listener_position = position;
+	}
+
+	Vector2f _mock_get_listener_position() {
+		return _mock_listener_position;
+	}
+
+	bool _mock_set_parameter(const char* name, float value) {
+		_mock_parameters[name] = value;
+		return true;
+	}
+
+	bool _mock_get_parameter(const char* name, float& value) {
+		auto it = _mock_parameters.find(name);
+		if (it == _mock_parameters.end()) return false;
+		value = it->second;
+		return true;
+	}
+
+	bool _mock_get_parameter_label(const char* name, int value, char* label, int label_size) {
+		return false;
+	}
+
+	BackendBus* _mock_find_bus(const char* path) {
+		return (BackendBus*)&_mock_buses[_mock_get_or_create_bus(path)];
+	}
+
+	void _mock_set_bus_volume(BackendBus* bus, float volume) {
+		((MockBus*)bus)->volume = volume;
+	}
+
+	float _mock_get_bus_volume(BackendBus* bus) {
+		return ((MockBus*)bus)->volume;
+	}
+
+	void _mock_stop_all_in_bus(BackendBus* bus) {
+		const size_t bus_index = _mock_get_bus_index((MockBus*)bus);
+		for (size_t i = 0; i < _mock_instance_end; ++i) {
+			MockEventInstance& instance = _mock_instances[i];
+			if (instance.desc && _mock_is_in_bus(instance.desc->bus_index, bus_index)) {
+				instance.playing = false;
+			}
+		}
+	}
+
+	const Backend mock_backend = {
+		.initialize = _mock_initialize,
+		.shutdown = _mock_shutdown,
+		.update = _mock_update,
+		.load_bank = _mock_load_bank,
+		.for_each_event = _mock_for_each_event,
+		.find_event = _mock_find_event,
+		.is_event_3d = _mock_is_event_3d,
+		.get_event_max_distance = _mock_get_event_max_distance,
+		.is_any_instance_playing = _mock_is_any_instance_playing,
+		.create_instance = _mock_create_instance,
+		.start_instance = _mock_start_instance,
+		.stop_instance = _mock_stop_instance,
+		.release_instance = _mock_release_instance,
+		.set_instance_volume = _mock_set_instance_volume,
+		.get_instance_volume = _mock_get_instance_volume,
+		.set_instance_position = _mock_set_instance_position,
+		.get_instance_position = _mock_get_instance_position,
+		.set_listener_position = _mock_set_listener_position,
+		.get_listener_position = _mock_get_listener_position,
+		.set_parameter = _mock_set_parameter,
+		.get_parameter = _mock_get_parameter,
+		.get_parameter_label = _mock_get_parameter_label,
+		.find_bus = _mock_find_bus,
+		.set_bus_volume = _mock_set_bus_volume,
+		.get_bus_volume = _mock_get_bus_volume,
+		.stop_all_in_bus = _mock_stop_all_in_bus,
+	};
+}
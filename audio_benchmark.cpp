@@ -0,0 +1,156 @@
+#include "stdafx.h"
+#ifdef _DEBUG
+#include <crtdbg.h>
+#include "audio_benchmark.h"
+#include "audio.h"
+#include "console.h"
+#include "window.h"
+
+namespace audio_benchmark {
+	const int _EVENT_COUNT = 256; // number of distinct events
+	const int _WARMUP_FRAMES = 60; // frames before we expect no more allocations
+	const float _SPAWN_RADIUS = 400.f; // pixels around the listener
+
+	bool _enabled = false;
+	int _events_per_frame = 2000;
+	int _frames_since_start = 0;
+	uint32_t _random_state = 0;
+	audio::EventId _event_ids[_EVENT_COUNT] = {};
+	std::vector<Handle<audio::Event>> _events; // events created last frame
+	float _smoothed_microseconds = 0.f;
+	size_t _last_frame_allocations = 0;
+	size_t _steady_state_allocations = 0;
+	// Heap allocations made by the current thread while the benchmark is enabled.
+	thread_local size_t _allocation_count = 0;
+	_CRT_ALLOC_HOOK _previous_alloc_hook = nullptr;
+
+	// Counts allocations through the debug heap, which every allocation goes through in debug builds.
+	// PITFALL: The hook is called from inside the heap, so it must not allocate itself.
+	int __cdecl _alloc_hook(int alloc_type, void* user_data, size_t size, int block_type,
+		long request_number, const unsigned char* file_name, int line_number) {
+		if (block_type != _CRT_BLOCK && (alloc_type == _HOOK_ALLOC || alloc_type == _HOOK_REALLOC)) {
+			++_allocation_count;
+		}
+		if (_previous_alloc_hook) {
+			return _previous_alloc_hook(alloc_type, user_data, size, block_type, request_number, file_name, line_number);
+		}
+		return 1; // allow the allocation
+	}
+
+	// A small LCG, so that every run creates the same sequence of events.
+	uint32_t _random() {
+		_random_state = _random_state * 1664525u + 1013904223u;
+		return _random_state >> 8;
+	}
+
+	float _random_float(float min, float max) {
+		return min + (max - min) * (float)(_random() & 0xffff) / 65535.f;
+	}
+
+	void _reset() {
+		_frames_since_start = 0;
+		_random_state = 12345;
+		_events.clear();
+		_events.reserve(_events_per_frame);
+		_smoothed_microseconds = 0.f;
+		_steady_state_allocations = 0;
+	}
+
+	void _start() {
+		_previous_alloc_hook = _CrtSetAllocHook(_alloc_hook);
+		audio::set_backend(audio::BackendType::Mock);
+		for (int i = 0; i < _EVENT_COUNT; ++i) {
+			const std::string path = "event:/benchmark/" + std::to_string(i);
+			_event_ids[i] = audio::get_event_id(path);
+			audio::is_any_playing(path); // resolves and caches the event
+		}
+		_reset();
+	}
+
+	void _stop() {
+		_events.clear();
+		audio::set_backend(audio::BackendType::Fmod);
+		_CrtSetAllocHook(_previous_alloc_hook);
+		_previous_alloc_hook = nullptr;
+	}
+
+	void disable() {
+		if (!_enabled) return;
+		_enabled = false;
+		_stop();
+	}
+
+	void show_imgui_window() {
+#ifdef _DEBUG_IMGUI
+		ImGui::Begin("Audio Benchmark");
+		if (ImGui::Checkbox("Enabled (Mock Backend)", &_enabled)) {
+			_enabled ? _start() : _stop();
+		}
+		if (ImGui::InputInt("Events Per Frame", &_events_per_frame)) {
+			_events_per_frame = std::max(_events_per_frame, 0);
+			_reset();
+		}
+		ImGui::Text("%.1f us per frame", _smoothed_microseconds);
+		if (_events_per_frame) {
+			ImGui::Text("%.3f us per event", _smoothed_microseconds / _events_per_frame);
+		}
+		ImGui::Value("Allocations Last Frame", (unsigned int)_last_frame_allocations);
+		ImGui::Value("Steady-State Allocations", (unsigned int)_steady_state_allocations);
+		ImGui::Value("Events Spawned", audio::get_events_spawned());
+		ImGui::Value("Events Culled", audio::get_events_culled());
+		ImGui::Value("Events Stolen", audio::get_events_stolen());
+		ImGui::End();
+#endif
+	}
+
+	void update() {
+		if (!_enabled) return;
+
+		const Vector2f listener_position = audio::get_listener_position();
+		const size_t start_allocations = _allocation_count;
+		const double start_time = window::get_elapsed_time();
+
+		// Stop half of last frame's events and move the other half.
+		for (size_t i = 0; i < _events.size(); ++i) {
+			if (i % 2) {
+				audio::stop_event(_events[i]);
+			} else {
+				audio::set_event_position(_events[i], listener_position + Vector2f(
+					_random_float(-_SPAWN_RADIUS, _SPAWN_RADIUS),
+					_random_float(-_SPAWN_RADIUS, _SPAWN_RADIUS)));
+			}
+		}
+		_events.clear();
+		for (int i = 0; i < _events_per_frame; ++i) {
+			Handle<audio::Event> handle = audio::create_event({
+				.id = _event_ids[_random() % _EVENT_COUNT],
+				.position = listener_position + Vector2f(
+					_random_float(-_SPAWN_RADIUS, _SPAWN_RADIUS),
+					_random_float(-_SPAWN_RADIUS, _SPAWN_RADIUS)),
+				.priority = (int)(_random() % 4) });
+			if (handle != Handle<audio::Event>()) {
+				_events.push_back(handle);
+			}
+		}
+		// SIC: The main loop updates the audio module as well, but we want to
+		// measure the backend update and the destroyed callbacks it triggers.
+		audio::update();
+
+		const double end_time = window::get_elapsed_time();
+		_last_frame_allocations = _allocation_count - start_allocations;
+
+		if (++_frames_since_start > _WARMUP_FRAMES && _last_frame_allocations) {
+			if (!_steady_state_allocations) {
+				console::log_error("Audio benchmark: " + std::to_string(_last_frame_allocations) +
+					" heap allocations in steady state");
+			}
+			_steady_state_allocations += _last_frame_allocations;
+		}
+
+		constexpr float smoothing_factor = 0.95f;
+		const float microseconds = (float)((end_time - start_time) * 1'000'000.0);
+		_smoothed_microseconds = smoothing_factor * _smoothed_microseconds + (1.f - smoothing_factor) * microseconds;
+	}
+}
+
+#endif
@@ -0,0 +1,13 @@
+#pragma once
+#ifdef _DEBUG
+
+namespace audio_benchmark {
+	void show_imgui_window();
+	// Switches back to the real audio backend if the benchmark is running. Call when hiding the window.
+	void disable();
+	// Creates, moves and stops a number of audio events against the mock audio backend,
+	// and measures how long it takes on the CPU and how many heap allocations it makes.
+	void update();
+}
+
+#endif
@@ -36,8 +36,7 @@ namespace background
 		} break;
 		case Type::MountainDusk: {
 			_layers.clear();
-			for (const std::string& path : _MOUNTAIN_DUSK_TEXTURE_PATHS) {
-				const Handle<graphics::Texture> texture = graphics::load_texture(path);
+			for (const Handle<graphics::Texture> texture : graphics::load_textures(_MOUNTAIN_DUSK_TEXTURE_PATHS)) {
 				if (texture == Handle<graphics::Texture>()) continue;
 				Layer& layer = _layers.emplace_back();
 				layer.texture = texture;
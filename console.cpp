@@ -3,13 +3,34 @@
 #include "console_commands.h"
 #include "window_events.h"
 #include "filesystem.h"
-#include <deque> // TODO: use a ringbuffer instead
+#include "ring_buffer.h"
 
 namespace console {
 	const Color _COLOR_COMMAND = Color(230, 230, 230, 255);
 	const Color _COLOR_LOG = Color(252, 191, 73, 255);
 	const Color _COLOR_LOG_ERROR = Color(220, 50, 47, 255);
 	const size_t _MAX_HISTORY = 512;
+	const size_t _MAX_QUEUED_COMMANDS = 256;
+
+	// A script command that has been parsed ahead of time, so that running the script
+	// again doesn't have to tokenize the line or look up the command by name.
+	struct _ScriptCommand {
+		std::string_view line; // Points into _Script::source
+		const Command* command = nullptr; // nullptr = failed to parse
+		ArgList args{};
+	};
+
+	struct _Script {
+		uint64_t last_write_time = 0;
+		std::string source;
+		std::vector<_ScriptCommand> commands;
+	};
+
+	// A queued command is either a command line to execute, or a script to continue executing.
+	struct _QueuedCommand {
+		const _Script* script = nullptr;
+		size_t next_command = 0;
+	};
 
 	bool _visible = false;
 	bool _has_focus = false;
@@ -18,11 +39,13 @@ namespace console {
 	std::stringstream _cout_stream;
 	std::stringstream _cerr_stream;
 	std::string _command_line;
-	std::deque<std::string> _command_queue; // TODO: use a ringbuffer instead
-	std::deque<std::string> _command_history; // TODO: use a ringbuffer instead
-	std::deque<std::string>::iterator _command_history_it = _command_history.end(); // TODO: use a ringbuffer instead
-	std::deque<std::pair<std::string, Color>> _history; // TODO: use a ringbuffer instead
+	StringRingBuffer<_QueuedCommand, _MAX_QUEUED_COMMANDS, 16 * 1024> _command_queue;
+	StringRingBuffer<std::monostate, _MAX_HISTORY, 32 * 1024> _command_history;
+	size_t _command_history_index = 0; // == _command_history.size() when not navigating
+	StringRingBuffer<Color, _MAX_HISTORY, 64 * 1024> _history;
 	std::unordered_map<window::Key, std::string> _key_bindings;
+	std::unordered_map<std::string, std::unique_ptr<_Script>> _scripts; // Cached by path
+	std::vector<std::unique_ptr<_Script>> _retired_scripts; // Recompiled while still queued
 
 #ifdef _DEBUG_IMGUI
 	int _input_text_callback(ImGuiInputTextCallbackData* data) {
@@ -49,16 +72,16 @@ namespace console {
 		if (data->EventFlag == ImGuiInputTextFlags_CallbackHistory) {
 			if (_command_history.empty()) return 0;
 			if (data->EventKey == ImGuiKey_UpArrow) {
-				if (_command_history_it > _command_history.begin()) {
-					_command_history_it--;
+				if (_command_history_index > 0) {
+					_command_history_index--;
 					data->DeleteChars(0, data->BufTextLen);
-					data->InsertChars(0, _command_history_it->c_str());
+					data->InsertChars(0, _command_history.c_str(_command_history_index));
 				}
 			} else if (data->EventKey == ImGuiKey_DownArrow) {
-				if (_command_history_it < _command_history.end() - 1) {
-					_command_history_it++;
+				if (_command_history_index + 1 < _command_history.size()) {
+					_command_history_index++;
 					data->DeleteChars(0, data->BufTextLen);
-					data->InsertChars(0, _command_history_it->c_str());
+					data->InsertChars(0, _command_history.c_str(_command_history_index));
 				}
 			}
 		}
@@ -67,6 +90,46 @@ namespace console {
 	}
 #endif
 
+	void _enqueue_command(std::string_view command_line, const _QueuedCommand& queued = {}) {
+		// PITFALL: The front of the queue may be executing right now, so we must never evict it.
+		if (_command_queue.would_evict(command_line.size())) {
+			log_error("Command queue is full, dropping: " + std::string(command_line));
+			return;
+		}
+		_command_queue.push_back(command_line, queued);
+	}
+
+	void _add_to_command_history(std::string_view command_line) {
+		_command_history.push_back(command_line);
+		_command_history_index = _command_history.size();
+		_history.push_back(command_line, _COLOR_COMMAND);
+	}
+
+	void _execute_script_command(const _ScriptCommand& script_command) {
+		if (!script_command.command) {
+			execute(script_command.line); // Parse it again so the error is logged in order
+			return;
+		}
+		_add_to_command_history(script_command.line);
+		script_command.command->callback(script_command.args);
+	}
+
+	void _compile_script(_Script& script) {
+		script.commands.clear();
+		std::string_view source = script.source;
+		while (!source.empty()) {
+			const size_t line_end = std::min(source.find('\n'), source.size());
+			const std::string_view line = source.substr(0, line_end);
+			source.remove_prefix(std::min(line_end + 1, source.size()));
+			if (line.empty() || line.starts_with("//")) continue;
+			_ScriptCommand& script_command = script.commands.emplace_back();
+			script_command.line = line;
+			if (!parse_command(line, script_command.command, script_command.args, false)) {
+				script_command.command = nullptr;
+			}
+		}
+	}
+
 	void initialize() {
 #if 0
 		// REDIRECT COUT AND CERR
@@ -105,9 +168,18 @@ namespace console {
 		// EXECUTE COMMAND QUEUE
 
 		while (!_sleep_timer && !_command_queue.empty()) {
-			execute(_command_queue.front());
+			const _QueuedCommand queued = _command_queue.data(0);
+			if (queued.script) {
+				_execute_script_command(queued.script->commands[queued.next_command]);
+				if (++_command_queue.data(0).next_command < queued.script->commands.size()) continue;
+			} else {
+				execute(_command_queue.string(0));
+			}
 			_command_queue.pop_front();
 		}
+		if (_command_queue.empty()) {
+			_retired_scripts.clear();
+		}
 
 		// SHOW CONSOLE WINDOW
 
@@ -139,8 +211,10 @@ namespace console {
 					false,
 					ImGuiWindowFlags_HorizontalScrollbar)) {
 					ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(4, 1)); // Tighten spacing
-					for (const auto& [line, color] : _history)
-						ImGui::TextColored(ImColor(color.r, color.g, color.b, color.a), line.c_str());
+					for (size_t i = 0; i < _history.size(); ++i) {
+						const Color& color = _history.data(i);
+						ImGui::TextColored(ImColor(color.r, color.g, color.b, color.a), "%s", _history.c_str(i));
+					}
 					ImGui::PopStyleVar();
 					if (ImGui::GetScrollY() >= ImGui::GetScrollMaxY())
 						ImGui::SetScrollHereY(1.0f); // Scroll to bottom
@@ -224,17 +298,11 @@ namespace console {
 	}
 
 	void log(std::string_view message) {
-		_history.emplace_back(message, _COLOR_LOG);
-		if (_history.size() > _MAX_HISTORY) {
-			_history.pop_front();
-		}
+		_history.push_back(message, _COLOR_LOG);
 	}
 
 	void log_error(std::string_view message, bool show_console) {
-		_history.emplace_back(message, _COLOR_LOG_ERROR);
-		if (_history.size() > _MAX_HISTORY) {
-			_history.pop_front();
-		}
+		_history.push_back(message, _COLOR_LOG_ERROR);
 		if (show_console) {
 			_visible = true;
 		}
@@ -243,18 +311,10 @@ namespace console {
 	void execute(std::string_view command_line, bool defer) {
 		if (command_line.starts_with("//")) return; // ignore comments
 		if (defer) {
-			_command_queue.emplace_back(command_line);
+			_enqueue_command(command_line);
 			return;
 		}
-		_command_history.emplace_back(command_line);
-		if (_command_history.size() > _MAX_HISTORY) {
-			_command_history.pop_front();
-		}
-		_command_history_it = _command_history.end();
-		_history.emplace_back(command_line, _COLOR_COMMAND);
-		if (_history.size() > _MAX_HISTORY) {
-			_history.pop_front();
-		}
+		_add_to_command_history(command_line);
 		parse_and_execute_command(command_line);
 	}
 
@@ -271,15 +331,23 @@ namespace console {
 	}
 
 	void execute_script_from_file(std::string_view path) {
-		std::string script;
-		if (!filesystem::read_text_file(path, script)) {
-			log_error("Failed to open console script: " + std::string(path));
-			return;
-		}
-		std::istringstream script_stream(std::move(script));
-		for (std::string line; std::getline(script_stream, line);) {
-			execute(line, true);
+		const uint64_t last_write_time = filesystem::get_last_write_time(path);
+		std::unique_ptr<_Script>& script = _scripts[std::string(path)];
+		if (!script || script->last_write_time != last_write_time) {
+			std::unique_ptr<_Script> new_script = std::make_unique<_Script>();
+			if (!filesystem::read_text_file(path, new_script->source)) {
+				log_error("Failed to open console script: " + std::string(path));
+				return;
+			}
+			new_script->last_write_time = last_write_time;
+			_compile_script(*new_script);
+			if (script && !_command_queue.empty()) {
+				_retired_scripts.push_back(std::move(script)); // It may still be queued
+			}
+			script = std::move(new_script);
 		}
+		if (script->commands.empty()) return;
+		_enqueue_command(path, { .script = script.get() });
 	}
 
 	void bind(window::Key key, std::string_view command_line) {
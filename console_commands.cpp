@@ -74,6 +74,16 @@ namespace console {
 	}
 
 	std::vector<Command> _commands; // Sorted by name
+	std::vector<uint16_t> _command_hash_table; // Open-addressed; stores indices into _commands plus one, 0 = empty
+
+	size_t _hash_command_name(std::string_view name) {
+		size_t hash = 2166136261u; // FNV-1a
+		for (char c : name) {
+			hash ^= (unsigned char)c;
+			hash *= 16777619u;
+		}
+		return hash;
+	}
 
 	bool operator<(const Command& left, const Command& right) {
 		return left.name < right.name; // Order by name
@@ -81,6 +91,7 @@ namespace console {
 
 	void clear_commands() {
 		_commands.clear();
+		_command_hash_table.clear();
 	}
 
 	void add_command(const Command&& command) {
@@ -89,22 +100,38 @@ namespace console {
 
 	void sort_commands_by_name() {
 		std::sort(_commands.begin(), _commands.end()); // Sort commands by name
+
+		// Build a hash table with a load factor of at most 50%, so that lookups rarely probe more than once.
+		size_t table_size = 16;
+		while (table_size < 2 * _commands.size()) {
+			table_size *= 2;
+		}
+		_command_hash_table.assign(table_size, 0);
+		for (size_t i = 0; i < _commands.size(); ++i) {
+			size_t slot = _hash_command_name(_commands[i].name) & (table_size - 1);
+			while (_command_hash_table[slot]) {
+				slot = (slot + 1) & (table_size - 1);
+			}
+			_command_hash_table[slot] = (uint16_t)(i + 1);
+		}
 	}
 
 	const Command* find_command_with_name(std::string_view name) {
-		// Do a binary search to find the command. We assume the commands are sorted by name.
-		auto it = std::lower_bound(_commands.begin(), _commands.end(), Command{ name });
-		if (it == _commands.end()) return nullptr;
-		if (it->name != name) return nullptr;
-		return &(*it);
+		if (_command_hash_table.empty()) return nullptr;
+		const size_t mask = _command_hash_table.size() - 1;
+		for (size_t slot = _hash_command_name(name) & mask; _command_hash_table[slot]; slot = (slot + 1) & mask) {
+			const Command& command = _commands[_command_hash_table[slot] - 1];
+			if (command.name == name) return &command;
+		}
+		return nullptr;
 	}
 
 	std::span<const Command> find_commands_whose_name_starts_with(std::string_view prefix) {
-		const size_t prefix_size = prefix.size();
-		auto [begin, end] = std::equal_range(_commands.begin(), _commands.end(), Command{ prefix },
-			[prefix_size](const Command& left, const Command& right) {
-			return strncmp(left.name.data(), right.name.data(), prefix_size) < 0;
-		});
+		// Since the commands are sorted by name, all names starting with the prefix form a contiguous range.
+		auto begin = std::lower_bound(_commands.begin(), _commands.end(), prefix,
+			[](const Command& command, std::string_view prefix) { return command.name < prefix; });
+		auto end = std::find_if_not(begin, _commands.end(),
+			[prefix](const Command& command) { return command.name.starts_with(prefix); });
 		return { begin, end };
 	}
 
@@ -139,36 +166,51 @@ namespace console {
 		void operator()(Vector2f& value) { is >> value.x >> value.y; }
 	};
 
-	void parse_and_execute_command(std::string_view command_line) {
+	bool parse_command(std::string_view command_line, const Command*& command, ArgList& args, bool log_errors) {
 		std::istringstream iss(std::string{ command_line });
 		std::string name;
-		if (!(iss >> name)) return;
-		const Command* command = find_command_with_name(name);
+		if (!(iss >> name)) return false;
+		command = find_command_with_name(name);
 		if (!command) {
-			log_error("Unknown command: " + std::string(name));
-			return;
+			if (log_errors) {
+				log_error("Unknown command: " + std::string(name));
+			}
+			return false;
 		}
 		if (!command->callback) {
-			log_error("Command is missing a callback: " + name);
-			return;
+			if (log_errors) {
+				log_error("Command is missing a callback: " + name);
+			}
+			return false;
 		}
-		ArgList args{};
+		args = {};
 		for (size_t i = 0; i < MAX_PARAMS; ++i) {
 			const Param& param = command->params[i];
 			if (param.type == ParamType::None) break; // End of parameters
 			iss.ignore(64, ' '); // Skip any leading spaces
 			if (iss.eof()) {
-				log_error("Missing argument: " + _format_command_param(param));
-				return;
+				if (log_errors) {
+					log_error("Missing argument: " + _format_command_param(param));
+				}
+				return false;
 			}
 			Arg& arg = args[i];
 			arg = _get_default_arg_for_param_type(param.type); // Ensure the arg is initialized with correct type
 			std::visit(ArgParserVisitor{ iss }, arg);
 			if (iss.fail()) {
-				log_error("Invalid argument: " + _format_command_param(param));
-				return;
+				if (log_errors) {
+					log_error("Invalid argument: " + _format_command_param(param));
+				}
+				return false;
 			}
 		}
+		return true;
+	}
+
+	void parse_and_execute_command(std::string_view command_line) {
+		const Command* command = nullptr;
+		ArgList args{};
+		if (!parse_command(command_line, command, args)) return;
 		command->callback(args); // Execute the command
 	}
 
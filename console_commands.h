@@ -50,11 +50,15 @@ namespace console {
 	void clear_commands();
 	void add_command(const Command&& command);
 	// Needs to be called after adding commands but before searching.
+	// Sorts the commands by name and builds the hash table used by find_command_with_name().
 	void sort_commands_by_name();
 
 	const Command* find_command_with_name(std::string_view name);
 	std::span<const Command> find_commands_whose_name_starts_with(std::string_view prefix);
 
+	// Parses a command line into a command and its arguments. Returns false if the line is empty
+	// or invalid, in which case the reason is logged as an error if log_errors is true.
+	bool parse_command(std::string_view command_line, const Command*& command, ArgList& args, bool log_errors = true);
 	void parse_and_execute_command(std::string_view command_line);
 
 	// Call once at engine startup.
@@ -5,11 +5,14 @@
 #include "audio.h"
 #include "map.h"
 #include "ui.h"
-//#include "shaders.h"
+#include "graphics.h"
+#include "graphics_globals.h"
 #include "ecs_player.h"
 #include "ecs_common.h"
 #include "ecs_camera.h"
 #include "ecs_vfx.h"
+#include "filesystem.h"
+#include "images.h"
 
 namespace console {
 	void _add_misc_commands() {
@@ -107,17 +110,95 @@ namespace console {
 			}
 		});
 
+		// FILESYSTEM
+
+		add_command({
+			.name = "pack_write",
+			.desc = "Packs all files in a directory into a pack file, used from the next startup",
+			.params = {
+				Param{ ParamType::String, "path", "The path of the pack file to write" },
+				Param{ ParamType::String, "directory", "The directory to pack" },
+			},
+			.callback = [](const ArgList& args) {
+				const std::string pack_path = get_string(args[0]);
+				if (filesystem::write_pack_file(pack_path, get_string(args[1]))) {
+					log("Wrote pack file: " + pack_path);
+				}
+			}
+		});
+
+		// IMAGES
+
+		add_command({
+			.name = "image_benchmark",
+			.desc = "Decodes all PNG images in a directory serially and then in parallel, and logs the timings",
+			.params = {
+				Param{ ParamType::String, "directory", "The directory to search for PNG images" },
+			},
+			.callback = [](const ArgList& args) {
+				std::vector<std::string> paths;
+				for (const filesystem::File& file : filesystem::get_all_files_in_directory(get_string(args[0]))) {
+					if (file.format == filesystem::FileFormat::PngImage) {
+						paths.push_back(file.path);
+					}
+				}
+				std::vector<images::Image> images(paths.size());
+				size_t byte_count = 0;
+
+				const double serial_start_time = window::get_elapsed_time();
+				for (size_t i = 0; i < paths.size(); ++i) {
+					images::load_image(paths[i], images[i]);
+				}
+				const double serial_seconds = window::get_elapsed_time() - serial_start_time;
+				for (images::Image& image : images) {
+					byte_count += (size_t)image.width * image.height * image.channels;
+					images::free_image(image);
+				}
+
+				const double parallel_start_time = window::get_elapsed_time();
+				images::load_images(paths, images);
+				const double parallel_seconds = window::get_elapsed_time() - parallel_start_time;
+				for (images::Image& image : images) {
+					images::free_image(image);
+				}
+
+				const double megabytes = byte_count / (1024.0 * 1024.0);
+				log("Decoded " + std::to_string(paths.size()) + " images (" + std::to_string((int)megabytes) + " MB)");
+				log("- Serial: " + std::to_string((int)(serial_seconds * 1000.0)) + " ms, " +
+					std::to_string((int)(megabytes / serial_seconds)) + " MB/s");
+				log("- Parallel: " + std::to_string((int)(parallel_seconds * 1000.0)) + " ms, " +
+					std::to_string((int)(megabytes / parallel_seconds)) + " MB/s");
+			}
+		});
+
+		// TEXTURES
+
+		add_command({
+			.name = "mip_generation",
+			.desc = "Sets how mips are generated for textures loaded from now on (None, Cpu or Gpu)",
+			.params = {
+				Param{ ParamType::String, "mode", "None, Cpu or Gpu" },
+			},
+			.callback = [](const ArgList& args) {
+				std::string mode_str = get_string(args[0]);
+				auto mode = magic_enum::enum_cast<graphics::MipGeneration>(mode_str, magic_enum::case_insensitive);
+				if (mode.has_value()) {
+					graphics::set_mip_generation(mode.value());
+				} else {
+					log_error("Unknown mip generation mode: " + mode_str);
+				}
+			}
+		});
+
 		// SHADERS
 
-#if 0
 		add_command({
 			.name = "reload_shaders",
 			.desc = "Reloads all shaders",
 			.callback = [](const ArgList& args) {
-				shaders::reload_assets();
+				graphics::reload_shaders();
 			}
 		});
-#endif
 
 		// AUDIO
 
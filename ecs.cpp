@@ -5,6 +5,7 @@
 #include "ecs_physics.h"
 #include "ecs_uniform_block.h"
 #include "ecs_sprites.h"
+#include "ecs_sprite_grid.h"
 #include "ecs_player.h"
 #include "ecs_ai.h"
 #include "ecs_animations.h"
@@ -27,10 +28,12 @@ namespace ecs {
 
 	void initialize() {
 		initialize_physics();
+		initialize_sprite_grid();
 	}
 
 	void shutdown() {
 		clear();
+		shutdown_sprite_grid();
 		shutdown_physics();
 	}
 
@@ -39,6 +42,11 @@ namespace ecs {
 	}
 
 	void update(float dt) {
+		// PITFALL: Blinks and shakes are removed and emplaced with deferred commands, which are applied
+		// in the order they were recorded. Expired ones have to be removed before the systems below
+		// record new ones, or the removal would be applied after the new blink or shake.
+		update_sprite_blinks(dt);
+		update_sprite_shakes(dt);
 		update_physics(dt);
 		update_players(dt);
 		update_portals(dt);
@@ -48,13 +56,11 @@ namespace ecs {
 		update_ai_logic(dt);
 		update_ai_graphics(dt);
 		update_lifetimes(dt);
-		destroy_entities_to_be_destroyed_at_end_of_frame();
+		apply_commands_at_end_of_frame();
 		update_tile_animations(dt);
 		update_flipbook_animations(dt);
 		update_animated_sprites(dt);
 		update_sprites_following_bodies();
-		update_sprite_blinks(dt);
-		update_sprite_shakes(dt);
 		update_cameras(dt);
 	}
 
@@ -66,6 +72,17 @@ namespace ecs {
 	}
 
 	//TODO: move this to a separate file
+
+	struct VisibleSprite {
+		entt::entity entity = entt::null;
+		sprites::Sprite* sprite = nullptr; // points into the registry, which doesn't change while drawing
+	};
+
+	std::vector<VisibleSprite> _visible_sprites;
+	std::vector<entt::entity> _sprite_grid_query_result;
+	std::vector<entt::entity> _uniform_block_entities; // in the order their blocks are laid out in the buffer
+	std::vector<entt::entity> _uploaded_uniform_block_entities;
+	uint32_t _uploaded_uniform_block_version = UINT32_MAX;
 	std::vector<UniformBlock> _uniform_blocks;
 
 	void draw_sprites(const Vector2f& camera_min, const Vector2f& camera_max) {
@@ -74,33 +91,59 @@ namespace ecs {
 		blink_sprites_before_drawing();
 		shake_sprites_before_drawing();
 
-		//TODO: don't to frustum culling twice, store ptrs in a vector or something
-		//or maybe emplace a tag?
-
-		_uniform_blocks.clear();
-
-		for (auto [entity, sprite, block] : _registry.view<sprites::Sprite, const UniformBlock>().each()) {
-			if (!(sprite.flags & sprites::SPRITE_VISIBLE)) continue;
-			if (sprite.position.x > camera_max.x) continue;
-			if (sprite.position.y > camera_max.y) continue;
-			if (sprite.position.x + sprite.size.x < camera_min.x) continue;
-			if (sprite.position.y + sprite.size.y < camera_min.y) continue;
-			sprite.uniform_buffer = graphics::sprite_uniform_buffer;
-			sprite.uniform_buffer_size = (uint32_t)sizeof(UniformBlock);
-			sprite.uniform_buffer_offset = (uint32_t)(_uniform_blocks.size() * sizeof(UniformBlock));
-			_uniform_blocks.push_back(block);
+		// CULL SPRITES
+
+		_visible_sprites.clear();
+		const auto cull_sprite = [&](entt::entity entity, sprites::Sprite& sprite) {
+			if (!(sprite.flags & sprites::SPRITE_VISIBLE)) return;
+			if (sprite.position.x > camera_max.x) return;
+			if (sprite.position.y > camera_max.y) return;
+			if (sprite.position.x + sprite.size.x < camera_min.x) return;
+			if (sprite.position.y + sprite.size.y < camera_min.y) return;
+			_visible_sprites.emplace_back(entity, &sprite);
+		};
+
+		// Most sprites are in the grid, so only those in cells near the camera need to be tested.
+		_sprite_grid_query_result.clear();
+		query_sprite_grid(camera_min, camera_max, _sprite_grid_query_result);
+		for (entt::entity entity : _sprite_grid_query_result) {
+			cull_sprite(entity, _registry.get<sprites::Sprite>(entity));
+		}
+		for (auto [entity, sprite] : _registry.view<sprites::Sprite>(entt::exclude<SpriteGridCell>).each()) {
+			cull_sprite(entity, sprite);
+		}
+
+		// ASSIGN UNIFORM BLOCK SLOTS
+
+		_uniform_block_entities.clear();
+		for (const VisibleSprite& visible : _visible_sprites) {
+			if (!_registry.all_of<UniformBlock>(visible.entity)) continue;
+			visible.sprite->uniform_buffer = graphics::sprite_uniform_buffer;
+			visible.sprite->uniform_buffer_size = (uint16_t)sizeof(UniformBlock);
+			visible.sprite->uniform_buffer_offset = (uint16_t)(_uniform_block_entities.size() * sizeof(UniformBlock));
+			_uniform_block_entities.push_back(visible.entity);
+		}
+
+		// UPLOAD UNIFORM BLOCKS
+
+		// Most frames, the same blocks are visible as in the last frame and none of them have changed,
+		// in which case the contents of the uniform buffer are still valid and we can skip the upload.
+		if (_uniform_block_entities != _uploaded_uniform_block_entities ||
+			get_uniform_block_version() != _uploaded_uniform_block_version) {
+			_uniform_blocks.clear();
+			for (entt::entity entity : _uniform_block_entities) {
+				_uniform_blocks.push_back(_registry.get<const UniformBlock>(entity));
+			}
+			graphics::update_buffer(graphics::sprite_uniform_buffer,
+				_uniform_blocks.data(), (unsigned int)_uniform_blocks.size() * sizeof(UniformBlock));
+			_uploaded_uniform_block_entities = _uniform_block_entities;
+			_uploaded_uniform_block_version = get_uniform_block_version();
 		}
 
-		graphics::update_buffer(graphics::sprite_uniform_buffer,
-			_uniform_blocks.data(), (unsigned int)_uniform_blocks.size() * sizeof(UniformBlock));
+		// DRAW SPRITES
 
-		for (auto [entity, sprite] : _registry.view<const sprites::Sprite>().each()) {
-			if (!(sprite.flags & sprites::SPRITE_VISIBLE)) continue;
-			if (sprite.position.x > camera_max.x) continue;
-			if (sprite.position.y > camera_max.y) continue;
-			if (sprite.position.x + sprite.size.x < camera_min.x) continue;
-			if (sprite.position.y + sprite.size.y < camera_min.y) continue;
-			sprites::add(sprite);
+		for (const VisibleSprite& visible : _visible_sprites) {
+			sprites::add(*visible.sprite);
 		}
 
 		sprites::sort();
@@ -80,7 +80,7 @@ namespace ecs {
     void debug_draw_ai() {
 #ifdef _DEBUG
         text::Text text{};
-        text.font = fonts::load_font("assets/fonts/Helvetica.ttf");;
+        text.font = fonts::load_font("assets/fonts/Helvetica.ttf", fonts::GlyphType::SDF);
         text.pixel_height = 48.f;
         text.scale = { 0.1f, 0.1f };
 
@@ -28,6 +28,18 @@ namespace ecs {
 		return graphics::load_texture(tileset_ptr->image_path);
 	}
 
+	// Returns the index of the frame that is showing at the given time.
+	unsigned int _get_frame_id(const tiled::Tile& tile, unsigned int time_ms) {
+		if (tile.animation_frame_duration_ms) {
+			return std::min(time_ms / tile.animation_frame_duration_ms, (unsigned int)tile.animation.size() - 1);
+		}
+		// Frame end times are sorted, since they are prefix sums of the frame durations.
+		const auto it = std::upper_bound(tile.animation.begin(), tile.animation.end(), time_ms,
+			[](unsigned int time_ms, const tiled::Frame& frame) { return time_ms < frame.end_ms; });
+		if (it == tile.animation.end()) return (unsigned int)tile.animation.size() - 1;
+		return (unsigned int)(it - tile.animation.begin());
+	}
+
 	void update_tile_animations(float dt) {
 		for (auto [entity, animation] : _registry.view<TileAnimation>().each()) {
 
@@ -41,24 +53,23 @@ namespace ecs {
 				// HACK: keep progress when changing tile_id so player walk/run animations don't restart
 				//animation.progress = 0.f;
 				animation._dirty = true;
+				// Resolve the tile once here, so that we don't have to look up the tileset every frame.
+				animation._tile = nullptr;
+				if (const tiled::Tileset* tileset = map::get_tileset(animation.tileset_id)) {
+					if (animation.tile_id < tileset->tiles.size()) {
+						const tiled::Tile& tile = tileset->tiles[animation.tile_id];
+						if (tile.animation_duration_ms) {
+							animation._tile = &tile;
+						}
+					}
+				}
 			}
 
-			const tiled::Tileset* tileset = map::get_tileset(animation.tileset_id);
-			if (!tileset) continue;
-			if (animation.tile_id >= tileset->tiles.size()) continue;
-			const tiled::Tile& tile = tileset->tiles[animation.tile_id];
-
-			if (tile.animation.empty()) continue;
-
-			unsigned int duration_ms = 0; // in milliseconds
-			for (const tiled::Frame& frame : tile.animation) {
-				duration_ms += frame.duration_ms;
-			}
-
-			if (!duration_ms) continue;
+			if (!animation._tile) continue;
+			const tiled::Tile& tile = *animation._tile;
 
 			// TODO: support for negative speed
-			const float delta_progress = animation.speed * dt * 1000.f / duration_ms;
+			const float delta_progress = animation.speed * dt * 1000.f / tile.animation_duration_ms;
 
 			animation.progress += delta_progress;
 			if (animation.progress >= 1.f) {
@@ -70,20 +81,12 @@ namespace ecs {
 				}
 			}
 
-			unsigned int time_ms = (unsigned int)(animation.progress * duration_ms);
-
-			for (unsigned int frame_id = 0; frame_id < tile.animation.size(); ++frame_id) {
-				const tiled::Frame& frame = tile.animation[frame_id];
-				if (time_ms >= frame.duration_ms) {
-					time_ms -= frame.duration_ms;
-					continue;
-				}
-				if (frame_id != animation._frame_id) {
-					animation._animated_tile_id = frame.tile_id;
-					animation._frame_id = frame_id;
-					animation._dirty = true;
-				}
-				break;
+			const unsigned int time_ms = (unsigned int)(animation.progress * tile.animation_duration_ms);
+			const unsigned int frame_id = _get_frame_id(tile, time_ms);
+			if (frame_id != animation._frame_id) {
+				animation._animated_tile_id = tile.animation[frame_id].tile_id;
+				animation._frame_id = frame_id;
+				animation._dirty = true;
 			}
 		}
 	}
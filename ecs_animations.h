@@ -1,5 +1,9 @@
 #pragma once
 
+namespace tiled {
+	struct Tile;
+}
+
 namespace ecs {
 
 	unsigned int get_tileset_id(std::string_view name);
@@ -8,6 +12,7 @@ namespace ecs {
 	struct TileAnimation {
 		unsigned int tileset_id = UINT_MAX; // index into tiled::Context::tilesets[]
 		unsigned int tile_id = UINT_MAX; // index into tiled::Tileset::tiles[]
+		const tiled::Tile* _tile = nullptr; // resolved when tile_id changes; nullptr if invalid or not animated
 		unsigned int _previous_tile_id = UINT_MAX;
 		unsigned int _animated_tile_id = UINT_MAX;
 		unsigned int _frame_id = 0; // index into tiled::Tile::animation[]
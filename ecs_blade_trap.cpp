@@ -44,7 +44,7 @@ namespace ecs {
 				b2Body_SetLinearVelocity(body, direction * _BLADE_TRAP_EXTEND_SPEED);
 
 				audio::stop_event(blade_trap.audio_event);
-				blade_trap.audio_event = audio::create_event({ .path = "event:/blade_trap/extend" });
+				blade_trap.audio_event = audio::create_event({ .path = "event:/blade_trap/extend", .position = ray_start });
 
 			} break;
 			case BladeTrapState::Impact: {
@@ -54,7 +54,7 @@ namespace ecs {
 				blade_trap.state = BladeTrapState::Retract;
 
 				audio::stop_event(blade_trap.audio_event);
-				blade_trap.audio_event = audio::create_event({ .path = "event:/blade_trap/retract" });
+				blade_trap.audio_event = audio::create_event({ .path = "event:/blade_trap/retract", .position = b2Body_GetPosition(body) });
 
 			} break;
 			case BladeTrapState::Retract: {
@@ -75,15 +75,10 @@ namespace ecs {
 				b2Body_SetType(body, b2_staticBody);
 				b2Body_SetTransform(body, blade_trap.start_position, b2Rot_identity);
 
-				{
-					SpriteShake& shake = emplace_sprite_shake(entity);
-					shake.duration = 0.2f;
-					shake.magnitude = 6.f;
-					shake.exponent = 2.f;
-				}
+				emplace_sprite_shake(entity, { .duration = 0.2f, .magnitude = 6.f, .exponent = 2.f });
 
 				audio::stop_event(blade_trap.audio_event);
-				blade_trap.audio_event = audio::create_event({ .path = "event:/blade_trap/reset" });
+				blade_trap.audio_event = audio::create_event({ .path = "event:/blade_trap/reset", .position = blade_trap.start_position });
 
 			} break;
 			}
@@ -109,15 +104,14 @@ namespace ecs {
 		blade_trap->state_timer = { 0.4f };
 		blade_trap->state_timer.start();
 
-		{
-			SpriteShake& shake = emplace_sprite_shake(blade_trap_entity);
-			shake.duration = 0.4f;
-			shake.magnitude = 7.f;
-			shake.exponent = 3.f;
-		}
+		emplace_sprite_shake(blade_trap_entity, { .duration = 0.4f, .magnitude = 7.f, .exponent = 3.f });
 
 		audio::stop_event(blade_trap->audio_event);
-		blade_trap->audio_event = audio::create_event({ .path = "event:/blade_trap/impact" });
+		Vector2f position;
+		if (b2BodyId body = get_body(blade_trap_entity); B2_IS_NON_NULL(body)) {
+			position = b2Body_GetPosition(body);
+		}
+		blade_trap->audio_event = audio::create_event({ .path = "event:/blade_trap/impact", .position = position });
 	}
 
 	void on_blade_trap_physics_event(const PhysicsEvent& ev) {
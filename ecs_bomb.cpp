@@ -31,10 +31,10 @@ namespace ecs
 			const float progress_after = bomb.explosion_timer.get_progress();
 
 			if (progress_before < 0.5f && progress_after >= 0.5f) {
-                SpriteBlink& blink = emplace_sprite_blink(entity);
-				blink.duration = bomb.explosion_timer.get_time_left();
-				blink.interval = 0.2f;
-				blink.color = { 255, 0, 0, 255 };
+				emplace_sprite_blink(entity, {
+					.duration = bomb.explosion_timer.get_time_left(),
+					.interval = 0.2f,
+					.color = { 255, 0, 0, 255 } });
 			}
 
             const Vector2f center = b2Body_GetPosition(body);
@@ -106,7 +106,11 @@ namespace ecs
 		if (bomb->ignited) return;
 		bomb->ignited = true;
         bomb->explosion_timer.start();
-		bomb->fuse_sound = audio::create_event({ .path = "event:/snd_bomb_fuse" });
+		Vector2f position;
+		if (b2BodyId body = get_body(entity); B2_IS_NON_NULL(body)) {
+			position = b2Body_GetPosition(body);
+		}
+		bomb->fuse_sound = audio::create_event({ .path = "event:/snd_bomb_fuse", .position = position });
     }
 
     bool apply_damage_to_bomb(entt::entity entity, const Damage& damage)
@@ -46,8 +46,9 @@ namespace ecs {
 		for (auto [entity, camera] : _registry.view<Camera>().each()) {
 
 			// If the camera has a follow target, center the view on the target.
-			if (b2BodyId body = get_body(camera.entity_to_follow); B2_IS_NON_NULL(body)) {
-				camera.center = b2Body_GetPosition(body);
+			// PITFALL: Use the same interpolated position as the target's sprite, or it jitters against the view.
+			if (B2_IS_NON_NULL(get_body(camera.entity_to_follow))) {
+				camera.center = get_interpolated_body_position(camera.entity_to_follow);
 			}
 
 			camera.center = _confine_camera_center(camera.center, camera.size, camera.confines_min, camera.confines_max);
@@ -2,13 +2,61 @@
 #include "ecs_common.h"
 #include "ecs_physics.h"
 #include "ecs_player.h"
+#include "ecs_sprite_grid.h"
 #include "tiled.h"
 
 namespace ecs {
 	struct Name { std::string value; };
 
+	struct Command {
+		CommandType type = CommandType::Destroy;
+		entt::entity entity = entt::null;
+		entt::id_type pool = 0;
+		uint32_t sequence = 0; // the order in which the command was recorded
+		ApplyCommandFunc apply = nullptr;
+		DiscardCommandFunc discard = nullptr;
+		void* payload = nullptr;
+	};
+
+	// Payloads are placement-new'd into fixed-size blocks that never move,
+	// so that components that aren't trivially relocatable can be stored safely.
+	constexpr size_t _COMMAND_ARENA_BLOCK_SIZE = 64 * 1024;
+
 	extern entt::registry _registry;
-	std::unordered_set<entt::entity> _entities_to_destroy_at_end_of_frame;
+	std::vector<Command> _commands;
+	std::vector<std::unique_ptr<std::byte[]>> _command_arena_blocks;
+	size_t _command_arena_block_index = 0;
+	size_t _command_arena_block_offset = 0;
+	std::vector<entt::entity> _entities_to_destroy; // sorted, used during apply_commands_at_end_of_frame()
+
+	void* _allocate_from_command_arena(size_t size, size_t alignment) {
+		assert(size <= _COMMAND_ARENA_BLOCK_SIZE);
+		if (!size) return nullptr;
+		while (true) {
+			if (_command_arena_block_index == _command_arena_blocks.size()) {
+				_command_arena_blocks.push_back(std::make_unique<std::byte[]>(_COMMAND_ARENA_BLOCK_SIZE));
+			}
+			const size_t offset = (_command_arena_block_offset + alignment - 1) & ~(alignment - 1);
+			if (offset + size <= _COMMAND_ARENA_BLOCK_SIZE) {
+				_command_arena_block_offset = offset + size;
+				return _command_arena_blocks[_command_arena_block_index].get() + offset;
+			}
+			++_command_arena_block_index;
+			_command_arena_block_offset = 0;
+		}
+	}
+
+	void _clear_commands() {
+		for (const Command& command : _commands) {
+			if (command.discard) {
+				command.discard(command.payload);
+			}
+		}
+		_commands.clear();
+		// Keep the blocks around so we don't have to reallocate them next frame.
+		_command_arena_block_index = 0;
+		_command_arena_block_offset = 0;
+	}
 
 	void update_lifetimes(float dt) {
 		for (auto [entity, lifetime] : _registry.view<Lifetime>().each()) {
@@ -19,18 +67,65 @@ namespace ecs {
 		}
 	}
 
-	void destroy_entities_to_be_destroyed_at_end_of_frame() {
-		for (entt::entity entity : _entities_to_destroy_at_end_of_frame) {
+	void apply_commands_at_end_of_frame() {
+		// PITFALL: Applying a command may fire signals whose handlers record new commands,
+		// so we take the current commands out of the buffer before applying them.
+		std::vector<Command> commands;
+		commands.swap(_commands);
+
+		std::ranges::sort(commands, [](const Command& a, const Command& b) {
+			if ((a.type == CommandType::Destroy) != (b.type == CommandType::Destroy)) {
+				return b.type == CommandType::Destroy;
+			}
+			if (a.pool != b.pool) return a.pool < b.pool;
+			if (a.entity != b.entity) return a.entity < b.entity;
+			return a.sequence < b.sequence;
+		});
+
+		_entities_to_destroy.clear();
+		for (const Command& command : commands) {
+			if (command.type == CommandType::Destroy) {
+				_entities_to_destroy.push_back(command.entity);
+			}
+		}
+		// Already sorted, since destroy commands have pool 0 and are sorted by entity.
+		_entities_to_destroy.erase(std::unique(_entities_to_destroy.begin(), _entities_to_destroy.end()),
+			_entities_to_destroy.end());
+
+		for (const Command& command : commands) {
+			switch (command.type) {
+			case CommandType::Emplace:
+			case CommandType::Remove: {
+				if (_registry.valid(command.entity) &&
+					!std::ranges::binary_search(_entities_to_destroy, command.entity)) {
+					command.apply(_registry, command.entity, command.payload);
+				} else if (command.discard) {
+					command.discard(command.payload);
+				}
+			} break;
+			}
+		}
+
+		for (entt::entity entity : _entities_to_destroy) {
 			if (_registry.valid(entity)) {
 				_registry.destroy(entity);
 			}
 		}
-		_entities_to_destroy_at_end_of_frame.clear();
+
+		// Commands recorded by signal handlers while applying are deferred to the next frame.
+		// Their payloads live in the arena, so we may only rewind it if there are none.
+		if (_commands.empty()) {
+			_command_arena_block_index = 0;
+			_command_arena_block_offset = 0;
+			commands.clear();
+			_commands.swap(commands); // reuse the capacity
+		}
 	}
 
 	void clear() {
 		_registry.clear();
-		_entities_to_destroy_at_end_of_frame.clear();
+		_clear_commands();
+		clear_sprite_grid();
 	}
 
 	entt::entity create() {
@@ -47,6 +142,10 @@ namespace ecs {
 			if (!storage.contains(entity)) continue;
 			if (storage.type() == entt::type_id<b2BodyId>()) {
 				deep_copy_and_emplace_body(copied_entity, *(b2BodyId*)storage.value(entity));
+			} else if (storage.type() == entt::type_id<SpriteGridCell>()) {
+				// PITFALL: The cell refers to the original entity's slot in the grid,
+				// so we can't copy it. Instead, we insert the copy into the grid below.
+				continue;
 			} else if (storage.type() == entt::type_id<Player>()) {
 				// TODO: deep copy player, since it holds a held item entity
 				storage.push(copied_entity, storage.value(entity));
@@ -54,6 +153,9 @@ namespace ecs {
 				storage.push(copied_entity, storage.value(entity));
 			}
 		}
+		if (_registry.all_of<SpriteGridCell>(entity)) {
+			update_sprite_in_grid(copied_entity, _registry.get<sprites::Sprite>(copied_entity));
+		}
 		return copied_entity;
 	}
 
@@ -67,9 +169,22 @@ namespace ecs {
 		}
 	}
 
+	void* _record_command(CommandType type, entt::entity entity, entt::id_type pool,
+		ApplyCommandFunc apply, DiscardCommandFunc discard, size_t payload_size, size_t payload_alignment) {
+		Command& command = _commands.emplace_back();
+		command.type = type;
+		command.entity = entity;
+		command.pool = pool;
+		command.sequence = (uint32_t)_commands.size() - 1;
+		command.apply = apply;
+		command.discard = discard;
+		command.payload = _allocate_from_command_arena(payload_size, payload_alignment);
+		return command.payload;
+	}
+
 	void destroy_at_end_of_frame(entt::entity entity) {
 		if (_registry.valid(entity)) {
-			_entities_to_destroy_at_end_of_frame.insert(entity);
+			_record_command(CommandType::Destroy, entity, 0, nullptr, nullptr, 0, 1);
 		}
 	}
 
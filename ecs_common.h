@@ -11,7 +11,7 @@ namespace ecs {
 	};
 
 	void update_lifetimes(float dt);
-	void destroy_entities_to_be_destroyed_at_end_of_frame();
+	void apply_commands_at_end_of_frame();
 
 	// ENTITY CREATION/DESTRUCTION
 
@@ -21,9 +21,58 @@ namespace ecs {
 	entt::entity deep_copy(entt::entity entity);
 	void set_lifetime(entt::entity entity, float time);
 	void destroy_immediately(entt::entity entity);
-	void destroy_at_end_of_frame(entt::entity entity);
 	bool valid(entt::entity entity);
 
+	// DEFERRED COMMANDS
+	// 
+	// Structural changes (emplace, remove, destroy) that are recorded during the frame and
+	// applied together in apply_commands_at_end_of_frame(). Commands are stored in a linear arena,
+	// then sorted before being applied: emplaces/removes come first, grouped by component pool and
+	// entity in the order they were recorded, and destructions come last, sorted by entity.
+	// Duplicate destructions are merged, and emplaces/removes on entities that are about to be
+	// destroyed are skipped. This makes the order in which signals such as on_destroy<b2BodyId>
+	// fire deterministic, and it is safe to record commands while iterating a view.
+
+	enum class CommandType : uint8_t {
+		Emplace,
+		Remove,
+		Destroy,
+	};
+
+	// Applies the command to the registry. Must also destroy the payload, if any.
+	using ApplyCommandFunc = void(*)(entt::registry& registry, entt::entity entity, void* payload);
+	// Destroys the payload without applying the command.
+	using DiscardCommandFunc = void(*)(void* payload);
+
+	// Allocates a command in the arena and returns a pointer to its (uninitialized) payload.
+	// Prefer the functions and templates below over calling this directly.
+	void* _record_command(CommandType type, entt::entity entity, entt::id_type pool,
+		ApplyCommandFunc apply, DiscardCommandFunc discard, size_t payload_size, size_t payload_alignment);
+
+	void destroy_at_end_of_frame(entt::entity entity);
+
+	template <typename T>
+	void emplace_at_end_of_frame(entt::entity entity, T value) {
+		void* payload = _record_command(CommandType::Emplace, entity, entt::type_hash<T>::value(),
+			[](entt::registry& registry, entt::entity entity, void* payload) {
+				T* value = (T*)payload;
+				registry.emplace_or_replace<T>(entity, std::move(*value));
+				value->~T();
+			},
+			[](void* payload) { ((T*)payload)->~T(); },
+			sizeof(T), alignof(T));
+		new (payload) T(std::move(value));
+	}
+
+	template <typename T>
+	void remove_at_end_of_frame(entt::entity entity) {
+		_record_command(CommandType::Remove, entity, entt::type_hash<T>::value(),
+			[](entt::registry& registry, entt::entity entity, void* payload) {
+				registry.remove<T>(entity);
+			},
+			nullptr, 0, 1);
+	}
+
 	// NAME AND TAG
 
 	void set_name(entt::entity entity, std::string_view name);
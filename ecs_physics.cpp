@@ -2,6 +2,7 @@
 #include "ecs_physics.h"
 #include "ecs_physics_filters.h"
 #include "ecs_common.h"
+#include "ecs_sprites.h"
 
 #ifdef _DEBUG
 #pragma comment(lib, "box2d-d.lib")
@@ -17,6 +18,15 @@ namespace ecs {
 
 	constexpr float _PHYSICS_TIME_STEP = 1.f / 60.f;
 	constexpr int _PHYSICS_SUB_STEP_COUNT = 4;
+	// If a frame takes very long (e.g. after a stall or while debugging), we don't try to
+	// catch up with more than this many steps, since doing so would make the next frame
+	// take even longer, and so on (the so-called "spiral of death"). The excess time is dropped.
+	constexpr int _PHYSICS_MAX_STEPS_PER_UPDATE = 5;
+
+	// The body's position before the last physics step, for interpolating between steps.
+	struct _PreviousBodyPosition {
+		Vector2f position;
+	};
 
 	extern entt::registry _registry;
 	b2WorldId _physics_world = b2_nullWorldId;
@@ -43,8 +53,22 @@ namespace ecs {
 	}
 
 	void update_physics(float dt) {
-		_physics_time_accumulator += dt;
-		for (; _physics_time_accumulator >= _PHYSICS_TIME_STEP; _physics_time_accumulator -= _PHYSICS_TIME_STEP) {
+		_physics_time_accumulator = std::min(_physics_time_accumulator + dt,
+			_PHYSICS_MAX_STEPS_PER_UPDATE * _PHYSICS_TIME_STEP);
+		const int step_count = (int)(_physics_time_accumulator / _PHYSICS_TIME_STEP);
+		_physics_time_accumulator -= step_count * _PHYSICS_TIME_STEP;
+
+		for (int step = 0; step < step_count; ++step) {
+
+			// STORE PREVIOUS BODY POSITIONS
+
+			// Body positions are interpolated between the positions before and after
+			// the last step, so only the positions before the last step need to be stored.
+			if (step == step_count - 1) {
+				for (auto [entity, body, previous] : _registry.view<const b2BodyId, _PreviousBodyPosition>().each()) {
+					previous.position = b2Body_GetPosition(body);
+				}
+			}
 
 			// STEP PHYSICS WORLD
 
@@ -156,6 +180,20 @@ namespace ecs {
 		}
 	}
 
+	float get_physics_interpolation_alpha() {
+		return std::clamp(_physics_time_accumulator / _PHYSICS_TIME_STEP, 0.f, 1.f);
+	}
+
+	Vector2f get_interpolated_body_position(entt::entity entity) {
+		const b2BodyId body = get_body(entity);
+		if (B2_IS_NULL(body)) return Vector2f();
+		const Vector2f position = b2Body_GetPosition(body);
+		if (const _PreviousBodyPosition* previous = _registry.try_get<_PreviousBodyPosition>(entity)) {
+			return lerp(previous->position, position, get_physics_interpolation_alpha());
+		}
+		return position;
+	}
+
 #ifdef _DEBUG_PHYSICS
 	Color _b2HexColor_to_Color(b2HexColor hex_color) {
 		Color color{};
@@ -379,6 +417,7 @@ namespace ecs {
 		body_def_copy.userData = (void*)(uintptr_t)entity;
 		b2BodyId body = b2CreateBody(_physics_world, &body_def_copy);
 		_registry.emplace_or_replace<b2BodyId>(entity, body);
+		_registry.emplace_or_replace<_PreviousBodyPosition>(entity, b2Body_GetPosition(body));
 		return body;
 	}
 
@@ -405,6 +444,7 @@ namespace ecs {
 	}
 
 	bool remove_body(entt::entity entity) {
+		_registry.remove<_PreviousBodyPosition>(entity);
 		return _registry.remove<b2BodyId>(entity);
 	}
 
@@ -6,6 +6,13 @@ namespace ecs {
 	void initialize_physics();
 	void shutdown_physics();
 	void update_physics(float dt);
+	// Returns how far (in the range [0, 1]) the current time is between the last physics step
+	// and the next one. Used to interpolate between the previous and current body positions.
+	float get_physics_interpolation_alpha();
+	// Returns the body's position interpolated between the last two physics steps, so that
+	// everything drawn at a body (sprites, camera) moves smoothly on any display refresh rate.
+	// Returns the zero vector if the entity has no body.
+	Vector2f get_interpolated_body_position(entt::entity entity);
 	void debug_draw_physics();
 
 	struct RaycastHit {
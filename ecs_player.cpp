@@ -123,6 +123,10 @@ namespace ecs {
 			const Vector2f velocity = b2Body_GetLinearVelocity(body);
 			Vector2f new_velocity; // will be modified differently depending on the state
 
+			if (player.stone_sliding_sound != Handle<audio::Event>()) {
+				audio::set_event_position(player.stone_sliding_sound, position);
+			}
+
 			enum class HeldItemType {
 				None,
 				Sword,
@@ -584,7 +588,11 @@ namespace ecs {
 		if (!player) return;
 		player->touching_pushable_block = true;
 		audio::stop_event(player->stone_sliding_sound); // Stop any previously playing sound
-		player->stone_sliding_sound = audio::create_event({ .path = "event:/props/stone_slide" });
+		Vector2f position;
+		if (b2BodyId body = get_body(player_entity); B2_IS_NON_NULL(body)) {
+			position = b2Body_GetPosition(body);
+		}
+		player->stone_sliding_sound = audio::create_event({ .path = "event:/props/stone_slide", .position = position });
 		if (b2BodyId body = get_body(pushable_block_entity); B2_IS_NON_NULL(body)) {
 			b2Body_SetType(body, b2_dynamicBody);
 		}
@@ -0,0 +1,120 @@
+#include "stdafx.h"
+#include "ecs_sprite_grid.h"
+
+namespace ecs {
+
+	constexpr float _SPRITE_GRID_CELL_SIZE = 64.f; // in pixels, i.e. 4x4 tiles
+
+	extern entt::registry _registry;
+	std::unordered_map<uint64_t, std::vector<entt::entity>> _sprite_grid_cells;
+	Vector2f _sprite_grid_max_sprite_size;
+	unsigned int _sprite_grid_cells_visited = 0;
+	unsigned int _sprite_grid_objects_visited = 0;
+
+	int32_t _get_sprite_grid_coordinate(float position) {
+		return (int32_t)floor(position / _SPRITE_GRID_CELL_SIZE);
+	}
+
+	uint64_t _get_sprite_grid_key(int32_t x, int32_t y) {
+		return ((uint64_t)(uint32_t)x << 32) | (uint64_t)(uint32_t)y;
+	}
+
+	uint64_t _get_sprite_grid_key(const Vector2f& position) {
+		return _get_sprite_grid_key(
+			_get_sprite_grid_coordinate(position.x),
+			_get_sprite_grid_coordinate(position.y));
+	}
+
+	void _remove_from_sprite_grid_cell(entt::entity entity, const SpriteGridCell& cell) {
+		auto it = _sprite_grid_cells.find(cell._key);
+		if (it == _sprite_grid_cells.end()) return;
+		std::vector<entt::entity>& entities = it->second;
+		if (cell._index >= entities.size() || entities[cell._index] != entity) return;
+		// Swap and pop, then fix the index of the entity that was moved.
+		entities[cell._index] = entities.back();
+		entities.pop_back();
+		if (cell._index < entities.size()) {
+			_registry.get<SpriteGridCell>(entities[cell._index])._index = cell._index;
+		}
+	}
+
+	void _insert_into_sprite_grid_cell(entt::entity entity, SpriteGridCell& cell, uint64_t key) {
+		std::vector<entt::entity>& entities = _sprite_grid_cells[key];
+		cell._key = key;
+		cell._index = (uint32_t)entities.size();
+		entities.push_back(entity);
+	}
+
+	void _on_destroy_SpriteGridCell(entt::registry& registry, entt::entity entity) {
+		_remove_from_sprite_grid_cell(entity, registry.get<SpriteGridCell>(entity));
+	}
+
+	void _on_destroy_Sprite(entt::registry& registry, entt::entity entity) {
+		registry.remove<SpriteGridCell>(entity);
+	}
+
+	void initialize_sprite_grid() {
+		_registry.on_destroy<SpriteGridCell>().connect<_on_destroy_SpriteGridCell>();
+		_registry.on_destroy<sprites::Sprite>().connect<_on_destroy_Sprite>();
+	}
+
+	void shutdown_sprite_grid() {
+		_registry.on_destroy<sprites::Sprite>().disconnect<_on_destroy_Sprite>();
+		_registry.on_destroy<SpriteGridCell>().disconnect<_on_destroy_SpriteGridCell>();
+		clear_sprite_grid();
+	}
+
+	void clear_sprite_grid() {
+		_sprite_grid_cells.clear();
+		_sprite_grid_max_sprite_size = {};
+	}
+
+	void update_sprite_in_grid(entt::entity entity, const sprites::Sprite& sprite) {
+		_sprite_grid_max_sprite_size.x = std::max(_sprite_grid_max_sprite_size.x, sprite.size.x);
+		_sprite_grid_max_sprite_size.y = std::max(_sprite_grid_max_sprite_size.y, sprite.size.y);
+		const uint64_t key = _get_sprite_grid_key(sprite.position);
+		if (SpriteGridCell* cell = _registry.try_get<SpriteGridCell>(entity)) {
+			if (cell->_key == key) return;
+			_remove_from_sprite_grid_cell(entity, *cell);
+			_insert_into_sprite_grid_cell(entity, *cell, key);
+		} else {
+			_insert_into_sprite_grid_cell(entity, _registry.emplace<SpriteGridCell>(entity), key);
+		}
+	}
+
+	void remove_sprite_from_grid(entt::entity entity) {
+		_registry.remove<SpriteGridCell>(entity);
+	}
+
+	void query_sprite_grid(const Vector2f& min, const Vector2f& max, std::vector<entt::entity>& entities) {
+		_sprite_grid_cells_visited = 0;
+		_sprite_grid_objects_visited = 0;
+		if (_sprite_grid_cells.empty()) return;
+
+		// A sprite whose top-left corner lies up to one max sprite size before the bounds can still
+		// overlap them. We also pad by one cell, since shaking may have moved sprites slightly
+		// from where they were binned.
+		const int32_t min_x = _get_sprite_grid_coordinate(min.x - _sprite_grid_max_sprite_size.x) - 1;
+		const int32_t min_y = _get_sprite_grid_coordinate(min.y - _sprite_grid_max_sprite_size.y) - 1;
+		const int32_t max_x = _get_sprite_grid_coordinate(max.x) + 1;
+		const int32_t max_y = _get_sprite_grid_coordinate(max.y) + 1;
+
+		for (int32_t y = min_y; y <= max_y; ++y) {
+			for (int32_t x = min_x; x <= max_x; ++x) {
+				++_sprite_grid_cells_visited;
+				auto it = _sprite_grid_cells.find(_get_sprite_grid_key(x, y));
+				if (it == _sprite_grid_cells.end()) continue;
+				_sprite_grid_objects_visited += (unsigned int)it->second.size();
+				entities.insert(entities.end(), it->second.begin(), it->second.end());
+			}
+		}
+	}
+
+	unsigned int get_sprite_grid_cells_visited() {
+		return _sprite_grid_cells_visited;
+	}
+
+	unsigned int get_sprite_grid_objects_visited() {
+		return _sprite_grid_objects_visited;
+	}
+}
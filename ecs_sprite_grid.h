@@ -0,0 +1,39 @@
+#pragma once
+#include "sprites.h"
+
+namespace ecs {
+
+	// A loose uniform grid over sprite positions, used to cull sprites against the camera
+	// without testing every sprite in the registry. Each sprite is binned by the cell
+	// containing its top-left corner. Queries are extended by the largest sprite size seen
+	// so far, so a sprite overlapping several cells is still found.
+	//
+	// Only sprites that have been explicitly inserted are in the grid. Static tile sprites
+	// are inserted once when the map is opened, and sprites following bodies are inserted
+	// and moved between cells by update_sprites_following_bodies(). All other sprites
+	// are culled by brute force, see draw_sprites() in ecs.cpp.
+
+	// Marks that the entity's sprite is in the grid. For internal use only!
+	struct SpriteGridCell {
+		uint64_t _key = 0; // packed cell coordinates
+		uint32_t _index = 0; // index into the cell's entity array
+	};
+
+	void initialize_sprite_grid();
+	void shutdown_sprite_grid();
+	void clear_sprite_grid();
+
+	// Inserts the sprite into the grid if it isn't already, or moves it to
+	// a different cell if its position has changed since it was inserted.
+	void update_sprite_in_grid(entt::entity entity, const sprites::Sprite& sprite);
+	void remove_sprite_from_grid(entt::entity entity);
+
+	// Appends to `entities` all sprites in the grid that may overlap the given bounds.
+	// The result is conservative: the caller still needs to test each sprite's bounds.
+	void query_sprite_grid(const Vector2f& min, const Vector2f& max, std::vector<entt::entity>& entities);
+
+	// DEBUGGING
+
+	unsigned int get_sprite_grid_cells_visited(); // in the last query
+	unsigned int get_sprite_grid_objects_visited(); // in the last query
+}
@@ -1,14 +1,20 @@
 #include "stdafx.h"
 #include "ecs_sprites.h"
+#include "ecs_common.h"
+#include "ecs_physics.h"
+#include "ecs_sprite_grid.h"
 #include "random.h"
 
 namespace ecs {
 	extern entt::registry _registry;
 
 	void update_sprites_following_bodies() {
+		// Physics runs at a fixed time step, so to avoid stuttering on displays whose refresh rate
+		// doesn't match it, we interpolate between the body positions before and after the last step.
 		for (auto [entity, sprite, body, follow] :
 			_registry.view<sprites::Sprite, b2BodyId, SpriteFollowBody>().each()) {
-			sprite.position = b2Body_GetPosition(body) + follow.offset;
+			sprite.position = get_interpolated_body_position(entity) + follow.offset;
+			update_sprite_in_grid(entity, sprite);
 		}
 	}
 
@@ -18,7 +24,7 @@ namespace ecs {
 				blink.duration -= dt;
 			}
 			if (blink.duration <= 0.f || blink.interval <= 0.f) {
-				_registry.erase<SpriteBlink>(entity);
+				remove_at_end_of_frame<SpriteBlink>(entity);
 				continue;
 			}
 		}
@@ -31,7 +37,7 @@ namespace ecs {
 				shake.duration -= dt;
 			}
 			if (shake.duration <= 0.f) {
-				_registry.erase<SpriteShake>(entity);
+				remove_at_end_of_frame<SpriteShake>(entity);
 				continue;
 			}
 			shake.magnitude *= pow(shake.duration / last_duration, std::max(shake.exponent, 0.f));
@@ -84,13 +90,13 @@ namespace ecs {
 		return _registry.try_get<SpriteFollowBody>(entity);
 	}
 
-	SpriteBlink& emplace_sprite_blink(entt::entity entity) {
-		return _registry.emplace_or_replace<SpriteBlink>(entity);
+	void emplace_sprite_blink(entt::entity entity, const SpriteBlink& blink) {
+		emplace_at_end_of_frame(entity, blink);
 	}
 
-	SpriteShake& emplace_sprite_shake(entt::entity entity) {
-		SpriteShake& shake = _registry.emplace_or_replace<SpriteShake>(entity);
-		shake._random_seed = random::range_ui(0, 128);
-		return shake;
+	void emplace_sprite_shake(entt::entity entity, const SpriteShake& shake) {
+		SpriteShake seeded_shake = shake;
+		seeded_shake._random_seed = random::range_ui(0, 128);
+		emplace_at_end_of_frame(entity, seeded_shake);
 	}
 }
\ No newline at end of file
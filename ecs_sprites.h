@@ -49,7 +49,8 @@ namespace ecs {
 	SpriteFollowBody& emplace_sprite_follow_body(entt::entity entity, const Vector2f& offset = { 0.f, 0.f });
 	SpriteFollowBody* get_sprite_follow_body(entt::entity entity);
 
-	SpriteBlink& emplace_sprite_blink(entt::entity entity);
-
-	SpriteShake& emplace_sprite_shake(entt::entity entity);
+	// The blink and shake are emplaced at the end of the frame, after any removal of an
+	// expired blink or shake that update_sprite_blinks() or update_sprite_shakes() recorded.
+	void emplace_sprite_blink(entt::entity entity, const SpriteBlink& blink);
+	void emplace_sprite_shake(entt::entity entity, const SpriteShake& shake);
 }
\ No newline at end of file
@@ -5,9 +5,11 @@
 namespace ecs
 {
 	extern entt::registry _registry;
+	uint32_t _uniform_block_version = 0;
 
     UniformBlock& emplace_uniform_block(entt::entity entity)
     {
+		increment_uniform_block_version();
 		return _registry.emplace_or_replace<UniformBlock>(entity);
     }
 
@@ -17,4 +19,14 @@ namespace ecs
 		memcpy(block.data, data, std::min(size, sizeof(block.data)));
 		return block;
     }
+
+	void increment_uniform_block_version()
+	{
+		++_uniform_block_version;
+	}
+
+	uint32_t get_uniform_block_version()
+	{
+		return _uniform_block_version;
+	}
 }
\ No newline at end of file
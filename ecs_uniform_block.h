@@ -12,6 +12,11 @@ namespace ecs
 		unsigned char data[256] = {};
 	};
 
+	// Emplacing a block increments the uniform block version, which tells the renderer that it
+	// needs to upload the blocks again. If you modify a block after the frame it was emplaced in,
+	// re-emplace it or call increment_uniform_block_version(), otherwise the change won't be seen.
 	UniformBlock& emplace_uniform_block(entt::entity entity);
 	UniformBlock& emplace_uniform_block(entt::entity entity, const void* data, size_t size);
+	void increment_uniform_block_version();
+	uint32_t get_uniform_block_version();
 }
\ No newline at end of file
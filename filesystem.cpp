@@ -1,10 +1,58 @@
 #include "stdafx.h"
 #include "filesystem.h"
+#include "console.h"
+#include "platform.h"
+#include "pool.h"
 #include <filesystem>
 #include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <zlib.h>
 
 namespace filesystem {
 
+	// PACK FILE FORMAT
+	// 
+	// [_PackHeader][_PackEntry * entry_count][paths][blobs]
+	// 
+	// The entries are sorted by path so they can be binary-searched in place, and each path
+	// is stored normalized, exactly like File::path. Blobs are aligned to _PACK_BLOB_ALIGNMENT
+	// and stored either as-is or zlib-compressed, whichever is smaller.
+
+	const char _PACK_MAGIC[4] = { 'P', 'A', 'C', 'K' };
+	const uint32_t _PACK_VERSION = 1;
+	const uint64_t _PACK_BLOB_ALIGNMENT = 16;
+
+	enum class _PackCompression : uint32_t {
+		None,
+		Zlib,
+	};
+
+	struct _PackHeader {
+		char magic[4] = {};
+		uint32_t version = 0;
+		uint32_t entry_count = 0;
+		uint32_t paths_size = 0;
+	};
+
+	struct _PackEntry {
+		uint64_t offset = 0; // from the start of the pack
+		uint64_t size = 0; // uncompressed
+		uint64_t stored_size = 0; // compressed, or equal to size if not compressed
+		uint32_t path_offset = 0; // from the start of the paths
+		uint32_t path_size = 0;
+		_PackCompression compression = _PackCompression::None;
+		uint32_t _padding = 0;
+	};
+
+	const std::string_view PACK_PATH = "assets.pack";
+
+	const unsigned char* _pack_data = nullptr; // Memory-mapped
+	size_t _pack_size = 0;
+	std::span<const _PackEntry> _pack_entries;
+	const char* _pack_paths = nullptr;
+
 	FileFormat _path_to_file_format(std::string_view path) {
 		if (path.ends_with(".txt"))  return FileFormat::Text;
 		if (path.ends_with(".png"))  return FileFormat::PngImage;
@@ -23,8 +71,291 @@ namespace filesystem {
 
 	std::vector<File> _files;
 
+	const size_t _WATCHED_FILES_PER_UPDATE = 32;
+
+	bool _watching = false;
+	std::vector<uint64_t> _file_write_times; // Same size as _files.
+	size_t _next_file_to_watch = 0;
+	std::vector<File> _changed_files;
+
+	std::string_view _get_pack_entry_path(const _PackEntry& entry) {
+		return { _pack_paths + entry.path_offset, entry.path_size };
+	}
+
+	const _PackEntry* _find_pack_entry(std::string_view path) {
+		if (!_pack_data) return nullptr;
+		const std::string normalized_path = get_normalized_path(path);
+		auto it = std::ranges::lower_bound(_pack_entries, normalized_path, {}, _get_pack_entry_path);
+		if (it == _pack_entries.end() || _get_pack_entry_path(*it) != normalized_path) return nullptr;
+		return &(*it);
+	}
+
+	// Writes the uncompressed contents of the entry to dest, which must hold entry.size bytes.
+	// PITFALL: This is called on the I/O thread as well, so it mustn't log anything.
+	bool _read_pack_entry(const _PackEntry& entry, unsigned char* dest) {
+		if (!entry.size) return true;
+		const unsigned char* src = _pack_data + entry.offset;
+		if (entry.compression == _PackCompression::None) {
+			memcpy(dest, src, entry.size);
+			return true;
+		}
+		uLongf dest_size = (uLongf)entry.size;
+		return uncompress(dest, &dest_size, src, (uLong)entry.stored_size) == Z_OK && dest_size == entry.size;
+	}
+
+	// Reads from the pack or from disk. Safe to call on the I/O thread.
+	bool _read_binary_file(std::string_view path, std::vector<unsigned char>& data) {
+		if (const _PackEntry* entry = _find_pack_entry(path)) {
+			data.resize(entry->size);
+			return _read_pack_entry(*entry, data.data());
+		}
+		std::ifstream file(std::string{ path }, std::ios::ate | std::ios::binary);
+		if (!file) return false;
+		data.resize(file.tellg());
+		file.seekg(0);
+		file.read(reinterpret_cast<char*>(data.data()), data.size());
+		return true;
+	}
+
+	// ASYNCHRONOUS READING
+
+	struct ReadRequest {
+		ReadStatus status = ReadStatus::Pending;
+		std::vector<unsigned char> data;
+		ReadCallback callback = nullptr;
+		void* userdata = nullptr;
+	};
+
+	struct _ReadJob {
+		Handle<ReadRequest> request;
+		std::string path;
+		ReadPriority priority = ReadPriority::Normal;
+		uint64_t sequence = 0; // Jobs with the same priority are read in FIFO order.
+	};
+
+	struct _ReadResult {
+		Handle<ReadRequest> request;
+		bool success = false;
+		std::vector<unsigned char> data;
+	};
+
+	// Only accessed on the main thread.
+	Pool<ReadRequest> _read_requests;
+	std::vector<Handle<ReadRequest>> _finished_requests_with_callbacks;
+	std::vector<Handle<ReadRequest>> _requests_to_call_back;
+	std::unordered_map<std::string, Handle<ReadRequest>> _prefetched_files; // Keyed by normalized path
+	uint64_t _next_read_sequence = 1; // 0 is reserved for jobs being waited on.
+
+	// Shared with the I/O thread and guarded by _io_mutex.
+	std::mutex _io_mutex;
+	std::condition_variable _io_job_added;
+	std::condition_variable _io_job_finished;
+	std::vector<_ReadJob> _io_jobs; // Max-heap, the most urgent job comes first.
+	std::vector<_ReadResult> _io_results;
+	bool _io_quit = false;
+	std::thread _io_thread;
+
+	bool _is_less_urgent(const _ReadJob& left, const _ReadJob& right) {
+		if (left.priority != right.priority) return left.priority < right.priority;
+		return left.sequence > right.sequence;
+	}
+
+	void _io_thread_main() {
+		std::unique_lock lock(_io_mutex);
+		while (true) {
+			_io_job_added.wait(lock, [] { return _io_quit || !_io_jobs.empty(); });
+			if (_io_quit) return;
+			std::pop_heap(_io_jobs.begin(), _io_jobs.end(), _is_less_urgent);
+			const _ReadJob job = std::move(_io_jobs.back());
+			_io_jobs.pop_back();
+			lock.unlock();
+			_ReadResult result{ .request = job.request };
+			result.success = _read_binary_file(job.path, result.data);
+			lock.lock();
+			_io_results.push_back(std::move(result));
+			_io_job_finished.notify_all();
+		}
+	}
+
+	// Moves the results of finished reads into their requests. Call with _io_mutex locked.
+	void _collect_read_results() {
+		for (_ReadResult& result : _io_results) {
+			ReadRequest* request = _read_requests.get(result.request);
+			if (!request) continue; // Freed while the read was in flight
+			request->status = result.success ? ReadStatus::Succeeded : ReadStatus::Failed;
+			request->data = std::move(result.data);
+			if (request->callback) {
+				_finished_requests_with_callbacks.push_back(result.request);
+			}
+		}
+		_io_results.clear();
+	}
+
+	void _start_io_thread() {
+		if (_io_thread.joinable()) return;
+		_io_quit = false;
+		_io_thread = std::thread(_io_thread_main);
+	}
+
+	void _stop_io_thread() {
+		if (!_io_thread.joinable()) return;
+		{
+			std::lock_guard lock(_io_mutex);
+			_io_quit = true;
+			_io_jobs.clear();
+			_io_results.clear();
+		}
+		_io_job_added.notify_all();
+		_io_thread.join();
+		_read_requests.clear();
+		_finished_requests_with_callbacks.clear();
+		_prefetched_files.clear();
+	}
+
+	Handle<ReadRequest> read_file_async(std::string_view path, ReadPriority priority, ReadCallback callback, void* userdata) {
+		const Handle<ReadRequest> handle = _read_requests.emplace();
+		ReadRequest* request = _read_requests.get(handle);
+		request->callback = callback;
+		request->userdata = userdata;
+		{
+			std::lock_guard lock(_io_mutex);
+			_io_jobs.push_back({ handle, std::string(path), priority, _next_read_sequence++ });
+			std::push_heap(_io_jobs.begin(), _io_jobs.end(), _is_less_urgent);
+		}
+		_io_job_added.notify_one();
+		return handle;
+	}
+
+	ReadStatus get_read_status(Handle<ReadRequest> handle) {
+		ReadRequest* request = _read_requests.get(handle);
+		if (!request) return ReadStatus::Failed;
+		if (request->status == ReadStatus::Pending) {
+			std::lock_guard lock(_io_mutex);
+			_collect_read_results();
+		}
+		return request->status;
+	}
+
+	ReadStatus wait_for_read(Handle<ReadRequest> handle) {
+		ReadRequest* request = _read_requests.get(handle);
+		if (!request) return ReadStatus::Failed;
+		std::unique_lock lock(_io_mutex);
+		for (_ReadJob& job : _io_jobs) {
+			if (job.request != handle) continue;
+			job.priority = ReadPriority::High;
+			job.sequence = 0;
+			std::make_heap(_io_jobs.begin(), _io_jobs.end(), _is_less_urgent);
+			break;
+		}
+		_collect_read_results();
+		while (request->status == ReadStatus::Pending) {
+			_io_job_finished.wait(lock, [] { return !_io_results.empty(); });
+			_collect_read_results();
+		}
+		return request->status;
+	}
+
+	std::span<const unsigned char> get_read_data(Handle<ReadRequest> handle) {
+		ReadRequest* request = _read_requests.get(handle);
+		if (!request) return {};
+		return request->data;
+	}
+
+	void free_read(Handle<ReadRequest> handle) {
+		ReadRequest* request = _read_requests.get(handle);
+		if (!request) return;
+		if (request->status == ReadStatus::Pending) {
+			std::lock_guard lock(_io_mutex);
+			auto it = std::ranges::find(_io_jobs, handle, &_ReadJob::request);
+			if (it != _io_jobs.end()) {
+				_io_jobs.erase(it);
+				std::make_heap(_io_jobs.begin(), _io_jobs.end(), _is_less_urgent);
+			}
+		}
+		request->data = {}; // SIC: The pool doesn't destroy freed elements.
+		_read_requests.free(handle);
+	}
+
+	void prefetch_file(std::string_view path, ReadPriority priority) {
+		std::string normalized_path = get_normalized_path(path);
+		if (_prefetched_files.contains(normalized_path)) return;
+		const Handle<ReadRequest> handle = read_file_async(normalized_path, priority);
+		_prefetched_files.emplace(std::move(normalized_path), handle);
+	}
+
+	// If the file was prefetched, waits for the read to finish and takes its data.
+	// Each prefetch is used only once; later reads of the same file go to the disk again.
+	bool _take_prefetched_file(std::string_view path, std::vector<unsigned char>& data, bool& success) {
+		if (_prefetched_files.empty()) return false;
+		auto it = _prefetched_files.find(get_normalized_path(path));
+		if (it == _prefetched_files.end()) return false;
+		const Handle<ReadRequest> handle = it->second;
+		_prefetched_files.erase(it);
+		success = wait_for_read(handle) == ReadStatus::Succeeded;
+		data = std::move(_read_requests.get(handle)->data);
+		free_read(handle);
+		return true;
+	}
+
+	bool _is_pack_valid(const unsigned char* data, size_t size) {
+		if (size < sizeof(_PackHeader)) return false;
+		const _PackHeader& header = *(const _PackHeader*)data;
+		if (memcmp(header.magic, _PACK_MAGIC, sizeof(_PACK_MAGIC)) != 0) return false;
+		if (header.version != _PACK_VERSION) return false;
+		const uint64_t paths_offset = sizeof(_PackHeader) + (uint64_t)header.entry_count * sizeof(_PackEntry);
+		if (paths_offset + header.paths_size > size) return false;
+		const _PackEntry* entries = (const _PackEntry*)(data + sizeof(_PackHeader));
+		for (uint32_t i = 0; i < header.entry_count; ++i) {
+			const _PackEntry& entry = entries[i];
+			if ((uint64_t)entry.path_offset + entry.path_size > header.paths_size) return false;
+			if (entry.offset > size || entry.stored_size > size - entry.offset) return false;
+			if (entry.compression == _PackCompression::None && entry.stored_size != entry.size) return false;
+		}
+		return true;
+	}
+
+	bool _open_pack(std::string_view path) {
+		size_t size = 0;
+		const unsigned char* data = (const unsigned char*)platform::map_file(std::string(path).c_str(), size);
+		if (!data) return false;
+		if (!_is_pack_valid(data, size)) {
+			console::log_error("Invalid pack file: " + std::string(path));
+			platform::unmap_file(data);
+			return false;
+		}
+		const _PackHeader& header = *(const _PackHeader*)data;
+		_pack_data = data;
+		_pack_size = size;
+		_pack_entries = { (const _PackEntry*)(data + sizeof(_PackHeader)), header.entry_count };
+		_pack_paths = (const char*)(_pack_entries.data() + _pack_entries.size());
+		return true;
+	}
+
+	void _close_pack() {
+		platform::unmap_file(_pack_data);
+		_pack_data = nullptr;
+		_pack_size = 0;
+		_pack_entries = {};
+		_pack_paths = nullptr;
+	}
+
 	void initialize() {
+		_stop_io_thread(); // PITFALL: It may be reading from the pack.
+		_close_pack();
 		_files.clear();
+		_watching = false;
+		_file_write_times.clear();
+		_changed_files.clear();
+		_start_io_thread();
+		if (_open_pack(PACK_PATH)) {
+			_files.reserve(_pack_entries.size());
+			for (const _PackEntry& entry : _pack_entries) {
+				File& file = _files.emplace_back();
+				file.path = _get_pack_entry_path(entry);
+				file.format = _path_to_file_format(file.path);
+			}
+			return; // The entries are already sorted by path.
+		}
 		for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(".")) {
 			if (!entry.is_regular_file()) continue;
 			File file{};
@@ -35,6 +366,64 @@ namespace filesystem {
 		std::ranges::sort(_files, {}, &File::path);
 	}
 
+	void shutdown() {
+		_stop_io_thread();
+		_close_pack();
+		_files.clear();
+		_watching = false;
+		_file_write_times.clear();
+		_changed_files.clear();
+	}
+
+	void _poll_watched_files() {
+		_changed_files.clear();
+		if (!_watching || _files.empty()) return;
+		for (size_t i = 0; i < std::min(_WATCHED_FILES_PER_UPDATE, _files.size()); ++i) {
+			_next_file_to_watch = (_next_file_to_watch + 1) % _files.size();
+			const uint64_t last_write_time = get_last_write_time(_files[_next_file_to_watch].path);
+			if (!last_write_time) continue; // Deleted, or in the middle of being replaced
+			if (last_write_time == _file_write_times[_next_file_to_watch]) continue;
+			_file_write_times[_next_file_to_watch] = last_write_time;
+			_changed_files.push_back(_files[_next_file_to_watch]);
+		}
+	}
+
+	void update() {
+		{
+			std::lock_guard lock(_io_mutex);
+			_collect_read_results();
+		}
+		// PITFALL: Callbacks may start new reads, so we iterate over a separate list.
+		_requests_to_call_back.swap(_finished_requests_with_callbacks);
+		for (Handle<ReadRequest> handle : _requests_to_call_back) {
+			const ReadRequest* request = _read_requests.get(handle);
+			if (!request) continue; // Freed by an earlier callback
+			request->callback(handle, request->userdata);
+			free_read(handle);
+		}
+		_requests_to_call_back.clear();
+		_poll_watched_files();
+	}
+
+	void set_watching_enabled(bool enabled) {
+		if (enabled == _watching) return;
+		if (enabled && _pack_data) {
+			console::log_error("Can't watch files while running from a pack file");
+			return;
+		}
+		_watching = enabled;
+		_changed_files.clear();
+		if (!_watching) return;
+		_file_write_times.resize(_files.size());
+		for (size_t i = 0; i < _files.size(); ++i) {
+			_file_write_times[i] = get_last_write_time(_files[i].path);
+		}
+	}
+
+	std::span<const File> get_changed_files() {
+		return _changed_files;
+	}
+
 	size_t get_file_count() {
 		return _files.size();
 	}
@@ -57,7 +446,47 @@ namespace filesystem {
 		return std::ranges::binary_search(_files, path, {}, &File::path);
 	}
 
+	uint64_t get_last_write_time(std::string_view path) {
+		std::error_code error;
+		const std::filesystem::file_time_type time = std::filesystem::last_write_time(path, error);
+		if (error) return 0;
+		return (uint64_t)time.time_since_epoch().count();
+	}
+
+	unsigned int copy_newer_files(std::string_view src_directory_path, std::string_view dest_directory_path) {
+		std::error_code error;
+		std::filesystem::create_directories(dest_directory_path, error);
+		unsigned int copied_file_count = 0;
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(src_directory_path, error)) {
+			if (!entry.is_regular_file(error)) continue;
+			const std::filesystem::file_time_type src_time = entry.last_write_time(error);
+			if (error) continue;
+			const std::filesystem::path dest_path = std::filesystem::path(dest_directory_path) / entry.path().filename();
+			const std::filesystem::file_time_type dest_time = std::filesystem::last_write_time(dest_path, error);
+			if (!error && dest_time >= src_time) continue;
+			if (std::filesystem::copy_file(entry.path(), dest_path, std::filesystem::copy_options::overwrite_existing, error)) {
+				copied_file_count++;
+			}
+		}
+		return copied_file_count;
+	}
+
 	bool read_text_file(std::string_view path, std::string& text) {
+		std::vector<unsigned char> prefetched_data;
+		bool prefetch_succeeded = false;
+		if (_take_prefetched_file(path, prefetched_data, prefetch_succeeded)) {
+			if (!prefetch_succeeded) return false;
+			text.assign(prefetched_data.begin(), prefetched_data.end());
+			std::erase(text, '\r'); // SIC: Prefetched files are read as binary.
+			return true;
+		}
+		if (const _PackEntry* entry = _find_pack_entry(path)) {
+			text.resize(entry->size);
+			if (!_read_pack_entry(*entry, (unsigned char*)text.data())) return false;
+			// SIC: Packed files are stored as binary, so we do the newline translation of text mode here.
+			std::erase(text, '\r');
+			return true;
+		}
 		std::ifstream file(std::string(path), std::ios::ate);
 		if (!file) return false;
 		text.resize(file.tellg());
@@ -76,13 +505,16 @@ namespace filesystem {
 		return true;
 	}
 
+	bool create_directories(std::string_view path) {
+		std::error_code error;
+		std::filesystem::create_directories(path, error);
+		return !error;
+	}
+
 	bool read_binary_file(std::string_view path, std::vector<unsigned char>& data) {
-		std::ifstream file(std::string{ path }, std::ios::ate | std::ios::binary);
-		if (!file) return false;
-		data.resize(file.tellg());
-		file.seekg(0);
-		file.read(reinterpret_cast<char*>(data.data()), data.size());
-		return true;
+		bool prefetch_succeeded = false;
+		if (_take_prefetched_file(path, data, prefetch_succeeded)) return prefetch_succeeded;
+		return _read_binary_file(path, data);
 	}
 
 	bool write_binary_file(std::string_view path, std::span<const unsigned char> data) {
@@ -92,6 +524,102 @@ namespace filesystem {
 		return true;
 	}
 
+	bool map_file(std::string_view path, MappedFile& file) {
+		unmap_file(file);
+		if (const _PackEntry* entry = _find_pack_entry(path)) {
+			if (entry->compression == _PackCompression::None) {
+				file.data = { _pack_data + entry->offset, entry->size };
+				return true;
+			}
+			file._buffer.resize(entry->size);
+			if (!_read_pack_entry(*entry, file._buffer.data())) return false;
+			file.data = file._buffer;
+			return true;
+		}
+		size_t size = 0;
+		file._view = platform::map_file(std::string(path).c_str(), size);
+		if (!file._view) {
+			// SIC: Empty files can't be mapped, but they still exist.
+			std::error_code error;
+			return std::filesystem::file_size(path, error) == 0 && !error;
+		}
+		file.data = { (const unsigned char*)file._view, size };
+		return true;
+	}
+
+	void unmap_file(MappedFile& file) {
+		platform::unmap_file(file._view);
+		file = {};
+	}
+
+	bool is_pack_loaded() {
+		return _pack_data != nullptr;
+	}
+
+	bool write_pack_file(std::string_view pack_path, std::string_view directory_path) {
+		if (_pack_data) {
+			console::log_error("Can't write a pack file while running from one");
+			return false;
+		}
+		const std::span<const File> files = get_all_files_in_directory(directory_path);
+		std::vector<_PackEntry> entries(files.size());
+		std::vector<std::vector<unsigned char>> blobs(files.size());
+		std::string paths;
+		for (size_t i = 0; i < files.size(); ++i) {
+			std::vector<unsigned char>& blob = blobs[i];
+			if (!read_binary_file(files[i].path, blob)) {
+				console::log_error("Failed to read file: " + files[i].path);
+				return false;
+			}
+			_PackEntry& entry = entries[i];
+			entry.size = blob.size();
+			entry.stored_size = blob.size();
+			entry.path_offset = (uint32_t)paths.size();
+			entry.path_size = (uint32_t)files[i].path.size();
+			paths += files[i].path;
+
+			// Only keep the compressed blob if it saves at least an eighth, since
+			// it has to be decompressed on every read and can't be mapped zero-copy.
+			uLongf compressed_size = compressBound((uLong)blob.size());
+			std::vector<unsigned char> compressed(compressed_size);
+			if (compress2(compressed.data(), &compressed_size, blob.data(), (uLong)blob.size(), Z_BEST_COMPRESSION) == Z_OK &&
+				compressed_size < blob.size() - blob.size() / 8) {
+				compressed.resize(compressed_size);
+				blob = std::move(compressed);
+				entry.stored_size = compressed_size;
+				entry.compression = _PackCompression::Zlib;
+			}
+		}
+
+		uint64_t offset = sizeof(_PackHeader) + entries.size() * sizeof(_PackEntry) + paths.size();
+		for (_PackEntry& entry : entries) {
+			offset = (offset + _PACK_BLOB_ALIGNMENT - 1) & ~(_PACK_BLOB_ALIGNMENT - 1);
+			entry.offset = offset;
+			offset += entry.stored_size;
+		}
+
+		_PackHeader header{};
+		memcpy(header.magic, _PACK_MAGIC, sizeof(_PACK_MAGIC));
+		header.version = _PACK_VERSION;
+		header.entry_count = (uint32_t)entries.size();
+		header.paths_size = (uint32_t)paths.size();
+
+		std::ofstream file(std::string(pack_path), std::ios::binary);
+		if (!file) {
+			console::log_error("Failed to open pack file for writing: " + std::string(pack_path));
+			return false;
+		}
+		file.write((const char*)&header, sizeof(header));
+		file.write((const char*)entries.data(), entries.size() * sizeof(_PackEntry));
+		file.write(paths.data(), paths.size());
+		for (size_t i = 0; i < entries.size(); ++i) {
+			const char padding[_PACK_BLOB_ALIGNMENT] = {};
+			file.write(padding, entries[i].offset - (uint64_t)file.tellp());
+			file.write((const char*)blobs[i].data(), blobs[i].size());
+		}
+		return (bool)file;
+	}
+
 	std::string get_normalized_path(std::string_view path) {
 		return std::filesystem::path(path).lexically_normal().string();
 	}
@@ -22,7 +22,12 @@ namespace filesystem {
 		FileFormat format = FileFormat::Unknown;
 	};
 
+	// If a pack file exists at PACK_PATH, the file list is read from its index instead of walking
+	// the working directory, and reads are served from the pack before falling back to loose files.
 	void initialize();
+	void shutdown();
+	// Runs the callbacks of finished asynchronous reads and polls watched files. Call once per frame.
+	void update();
 
 	// FILES
 
@@ -30,14 +35,86 @@ namespace filesystem {
 	std::span<const File> get_all_files();
 	std::span<const File> get_all_files_in_directory(std::string_view directory_path); // recursive
 	bool file_exists(std::string_view path);
+	// Returns an opaque timestamp that changes whenever the file is written to, or 0 if the file doesn't exist.
+	uint64_t get_last_write_time(std::string_view path);
+	// Copies the files directly inside src_directory_path that are missing or older in dest_directory_path.
+	// Returns the number of files copied.
+	unsigned int copy_newer_files(std::string_view src_directory_path, std::string_view dest_directory_path);
+
+	// FILE WATCHING
+	// 
+	// When enabled, update() polls the last write times of a few indexed files per frame, so that
+	// edited assets can be hot-reloaded. Files created after initialize() aren't watched.
+
+	void set_watching_enabled(bool enabled);
+	// Returns the files whose last write time changed during the last update().
+	std::span<const File> get_changed_files();
 
 	// READING/WRITING FILES
 
 	bool read_text_file(std::string_view path, std::string& text);
 	bool write_text_file(std::string_view path, std::string_view text);
+	// Creates the directory and any missing parent directories. Returns true if they exist afterwards.
+	bool create_directories(std::string_view path);
 	bool read_binary_file(std::string_view path, std::vector<unsigned char>& data);
 	bool write_binary_file(std::string_view path, std::span<const unsigned char> data);
 
+	// ASYNCHRONOUS READING
+	// 
+	// Reads are serviced in priority order by a single I/O thread. A request either has a callback,
+	// in which case update() calls it once the read has finished and then frees the request,
+	// or it doesn't, in which case the caller polls or waits for it and frees it when done.
+
+	enum class ReadPriority {
+		Low,
+		Normal,
+		High,
+	};
+
+	enum class ReadStatus {
+		Pending,
+		Succeeded,
+		Failed,
+	};
+
+	struct ReadRequest;
+	using ReadCallback = void (*)(Handle<ReadRequest> request, void* userdata);
+
+	Handle<ReadRequest> read_file_async(std::string_view path, ReadPriority priority = ReadPriority::Normal,
+		ReadCallback callback = nullptr, void* userdata = nullptr);
+	ReadStatus get_read_status(Handle<ReadRequest> request);
+	// Blocks until the read has finished, moving it to the front of the queue if it hasn't started yet.
+	ReadStatus wait_for_read(Handle<ReadRequest> request);
+	// The data stays valid until the request is freed.
+	std::span<const unsigned char> get_read_data(Handle<ReadRequest> request);
+	// Cancels the read if it hasn't finished yet.
+	void free_read(Handle<ReadRequest> request);
+	// Starts reading the file in the background, so that the next read_text_file() or
+	// read_binary_file() of the same path only has to wait for it to finish.
+	void prefetch_file(std::string_view path, ReadPriority priority = ReadPriority::Low);
+
+	// MEMORY-MAPPED FILES
+
+	struct MappedFile {
+		std::span<const unsigned char> data;
+		const void* _view = nullptr; // For internal use only
+		std::vector<unsigned char> _buffer; // For internal use only
+	};
+
+	// Gives read-only access to the contents of a file without copying them, unless they are
+	// compressed in the pack. The data stays valid until unmap_file() is called on the file.
+	bool map_file(std::string_view path, MappedFile& file);
+	void unmap_file(MappedFile& file);
+
+	// PACK FILES
+
+	extern const std::string_view PACK_PATH;
+
+	bool is_pack_loaded();
+	// Packs all loose files in the directory (recursively) into a new pack file.
+	// The pack is used starting with the next call to initialize().
+	bool write_pack_file(std::string_view pack_path, std::string_view directory_path);
+
 	// PATHS
 
 	std::string get_normalized_path(std::string_view path);
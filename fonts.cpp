@@ -3,6 +3,7 @@
 #include "pool.h"
 #include "console.h"
 #include "graphics.h"
+#include "graphics_globals.h"
 #include "filesystem.h"
 
 #define STB_TRUETYPE_IMPLEMENTATION
@@ -11,31 +12,178 @@
 namespace fonts {
 	const int ATLAS_TEXTURE_SIZE = 1024;
 
+	// Glyphs and kerning for codepoints below this are kept in flat tables,
+	// while other codepoints go through a hash map.
+	constexpr char32_t _FLAT_CODEPOINT_COUNT = 256; // ASCII + Latin-1 Supplement
+	constexpr float _GLYPH_FONT_SIZE = 30.f; //Hardcoded for now
+	// SDF glyphs stay sharp at any pixel height, so they can be rasterized smaller than bitmap glyphs.
+	constexpr float _SDF_GLYPH_FONT_SIZE = 24.f;
+	constexpr int _SDF_PADDING = 4; // in pixels; how far outside the glyph outline the distance field reaches
+	constexpr unsigned char _SDF_ONEDGE_VALUE = 128; // the distance field value on the glyph outline
+	constexpr float _SDF_PIXEL_DIST_SCALE = (float)_SDF_ONEDGE_VALUE / _SDF_PADDING; // value change per pixel of distance
+
 	struct Font {
 		std::vector<unsigned char> data;
 		stbtt_fontinfo info{};
+		GlyphType glyph_type = GlyphType::Bitmap;
 		int ascent = 0; // The (unscaled) coordinate above the baseline the font extends.
 		int descent = 0; // The (unscaled) coordinate below the baseline the font extends; typically negative.
 		int line_gap = 0; // The (unscaled) spacing between one row's descent and the next row's ascent.
 
 		std::vector<unsigned char> atlas_pixels; // size = ATLAS_TEXTURE_SIZE * ATLAS_TEXTURE_SIZE
 		stbtt_pack_context pack_context{};
-		std::unordered_map<char32_t, stbtt_packedchar> packed_chars;
 		Handle<graphics::Texture> atlas_texture;
-		bool atlas_texture_needs_updating = true;
+		// The union of all rectangles that have been packed since the atlas texture was last updated.
+		// Only this part of the atlas is uploaded, so packing a new glyph doesn't cost a full upload.
+		int atlas_dirty_x0 = 0;
+		int atlas_dirty_y0 = 0;
+		int atlas_dirty_x1 = ATLAS_TEXTURE_SIZE;
+		int atlas_dirty_y1 = ATLAS_TEXTURE_SIZE;
+
+		// Glyphs are cached the first time they are requested, which is also when they are packed.
+		std::array<Glyph, _FLAT_CODEPOINT_COUNT> flat_glyphs{};
+		std::array<bool, _FLAT_CODEPOINT_COUNT> flat_glyphs_cached{};
+		std::unordered_map<char32_t, Glyph> glyphs; // for codepoints >= _FLAT_CODEPOINT_COUNT
+		// Precomputed when loading the font; indexed by [codepoint1 * _FLAT_CODEPOINT_COUNT + codepoint2].
+		std::vector<int16_t> flat_kerning_advances;
 	};
 
+	std::vector<unsigned char> _atlas_dirty_pixels; // scratch buffer for uploading dirty rectangles
+
+	void _precompute_flat_kerning_advances(Font& font) {
+		font.flat_kerning_advances.assign(_FLAT_CODEPOINT_COUNT * _FLAT_CODEPOINT_COUNT, 0);
+		if (!font.info.kern && !font.info.gpos) return; // The font has no kerning tables.
+		// Most control characters have no glyph, so we skip those pairs to save time.
+		int glyph_indices[_FLAT_CODEPOINT_COUNT] = {};
+		for (char32_t codepoint = 0; codepoint < _FLAT_CODEPOINT_COUNT; ++codepoint) {
+			glyph_indices[codepoint] = stbtt_FindGlyphIndex(&font.info, codepoint);
+		}
+		for (char32_t codepoint1 = 0; codepoint1 < _FLAT_CODEPOINT_COUNT; ++codepoint1) {
+			if (!glyph_indices[codepoint1]) continue;
+			for (char32_t codepoint2 = 0; codepoint2 < _FLAT_CODEPOINT_COUNT; ++codepoint2) {
+				if (!glyph_indices[codepoint2]) continue;
+				font.flat_kerning_advances[codepoint1 * _FLAT_CODEPOINT_COUNT + codepoint2] =
+					(int16_t)stbtt_GetGlyphKernAdvance(&font.info, glyph_indices[codepoint1], glyph_indices[codepoint2]);
+			}
+		}
+	}
+
+	void _mark_atlas_dirty(Font& font, int x0, int y0, int x1, int y1) {
+		if (x0 >= x1 || y0 >= y1) return;
+		font.atlas_dirty_x0 = std::min(font.atlas_dirty_x0, x0);
+		font.atlas_dirty_y0 = std::min(font.atlas_dirty_y0, y0);
+		font.atlas_dirty_x1 = std::max(font.atlas_dirty_x1, x1);
+		font.atlas_dirty_y1 = std::max(font.atlas_dirty_y1, y1);
+	}
+
+	bool _is_glyph_cached(const Font& font, char32_t codepoint) {
+		if (codepoint < _FLAT_CODEPOINT_COUNT) return font.flat_glyphs_cached[codepoint];
+		return font.glyphs.contains(codepoint);
+	}
+
+	void _cache_glyph(Font& font, char32_t codepoint, const Glyph& glyph) {
+		if (codepoint < _FLAT_CODEPOINT_COUNT) {
+			font.flat_glyphs[codepoint] = glyph;
+			font.flat_glyphs_cached[codepoint] = true;
+		} else {
+			font.glyphs[codepoint] = glyph;
+		}
+	}
+
+	void _pack_sdf_glyphs(Font& font, char32_t first_codepoint, unsigned int count) {
+		const float scale = stbtt_ScaleForPixelHeight(&font.info, _SDF_GLYPH_FONT_SIZE);
+		std::vector<unsigned char*> bitmaps(count);
+		std::vector<stbrp_rect> rects(count);
+		std::vector<Glyph> glyphs(count);
+		for (unsigned int i = 0; i < count; ++i) {
+			const char32_t codepoint = first_codepoint + i;
+			Glyph& glyph = glyphs[i];
+			stbtt_GetCodepointHMetrics(&font.info, codepoint, &glyph.advance_width, &glyph.left_side_bearing);
+			int width = 0, height = 0, xoff = 0, yoff = 0;
+			bitmaps[i] = stbtt_GetCodepointSDF(&font.info, scale, codepoint, _SDF_PADDING,
+				_SDF_ONEDGE_VALUE, _SDF_PIXEL_DIST_SCALE, &width, &height, &xoff, &yoff);
+			if (bitmaps[i]) {
+				// The distance field extends past the glyph outline by _SDF_PADDING on every side,
+				// and the bitmap size and offsets already include it. The quad is sized from them
+				// so that it covers exactly the atlas region, or the glyph would be stretched.
+				// PITFALL: The bitmap offsets are y-down, while the glyph box is y-up.
+				glyph.x0 = (int)roundf(xoff / scale);
+				glyph.x1 = glyph.x0 + (int)roundf(width / scale);
+				glyph.y1 = (int)roundf(-yoff / scale);
+				glyph.y0 = glyph.y1 - (int)roundf(height / scale);
+			}
+			// Leave a one-pixel gap between glyphs so linear filtering doesn't bleed into neighbors.
+			rects[i].id = (int)i;
+			rects[i].w = bitmaps[i] ? width + 1 : 0;
+			rects[i].h = bitmaps[i] ? height + 1 : 0;
+		}
+		stbtt_PackFontRangesPackRects(&font.pack_context, rects.data(), (int)count);
+		for (unsigned int i = 0; i < count; ++i) {
+			const stbrp_rect& rect = rects[i];
+			Glyph& glyph = glyphs[i];
+			if (bitmaps[i] && rect.was_packed) {
+				const int width = rect.w - 1;
+				const int height = rect.h - 1;
+				for (int y = 0; y < height; ++y) {
+					memcpy(font.atlas_pixels.data() + (rect.y + y) * ATLAS_TEXTURE_SIZE + rect.x,
+						bitmaps[i] + y * width, width);
+				}
+				glyph.s0 = rect.x;
+				glyph.t0 = rect.y;
+				glyph.s1 = rect.x + width;
+				glyph.t1 = rect.y + height;
+				_mark_atlas_dirty(font, glyph.s0, glyph.t0, glyph.s1, glyph.t1);
+			} else if (bitmaps[i]) {
+				console::log_error("Font atlas is full, failed to pack SDF glyph: " + std::to_string((uint32_t)(first_codepoint + i)));
+			}
+			stbtt_FreeSDF(bitmaps[i], nullptr);
+			_cache_glyph(font, first_codepoint + i, glyph);
+		}
+	}
+
+	void _pack_glyphs(Font& font, char32_t first_codepoint, unsigned int count) {
+		if (!count) return;
+		if (font.glyph_type == GlyphType::SDF) {
+			_pack_sdf_glyphs(font, first_codepoint, count);
+			return;
+		}
+		std::vector<stbtt_packedchar> packed_chars(count);
+		stbtt_PackFontRange(&font.pack_context, font.data.data(), 0, _GLYPH_FONT_SIZE,
+			(int)first_codepoint, (int)count, packed_chars.data());
+		for (unsigned int i = 0; i < count; ++i) {
+			const char32_t codepoint = first_codepoint + i;
+			const stbtt_packedchar& packed_char = packed_chars[i];
+			Glyph glyph{};
+			stbtt_GetCodepointHMetrics(&font.info, codepoint, &glyph.advance_width, &glyph.left_side_bearing);
+			stbtt_GetCodepointBox(&font.info, codepoint, &glyph.x0, &glyph.y0, &glyph.x1, &glyph.y1);
+			glyph.s0 = packed_char.x0;
+			glyph.t0 = packed_char.y0;
+			glyph.s1 = packed_char.x1;
+			glyph.t1 = packed_char.y1;
+			_mark_atlas_dirty(font, glyph.s0, glyph.t0, glyph.s1, glyph.t1);
+			_cache_glyph(font, codepoint, glyph);
+		}
+	}
+
 	Pool<Font> _font_pool;
 	std::unordered_map<std::string, Handle<Font>> _font_path_to_handle;
 
-	Handle<Font> load_font(const std::string& path) {
+	Handle<Font> load_font(const std::string& path, GlyphType glyph_type) {
 		const std::string normalized_path = filesystem::get_normalized_path(path);
-		if (auto it = _font_path_to_handle.find(normalized_path);  it != _font_path_to_handle.end()) {
+		// The same font file may be loaded once per glyph type, since each needs its own atlas.
+		const std::string key = glyph_type == GlyphType::SDF ? normalized_path + ":sdf" : normalized_path;
+		if (auto it = _font_path_to_handle.find(key);  it != _font_path_to_handle.end()) {
 			return it->second;
 		}
 
+		if (glyph_type == GlyphType::SDF && graphics::text_sdf_frag == Handle<graphics::FragmentShader>()) {
+			// The SDF atlas looks wrong when drawn with text_frag, so we fall back to bitmap glyphs.
+			console::log_error("SDF text shader is not loaded, using bitmap glyphs for font: " + normalized_path);
+			return load_font(path, GlyphType::Bitmap);
+		}
+
 		Font font{};
-		font.data;
+		font.glyph_type = glyph_type;
 		if (!filesystem::read_binary_file(path, font.data)) {
 			console::log_error("Failed to open font file: " + normalized_path);
 			return Handle<Font>();
@@ -48,9 +196,11 @@ namespace fonts {
 		}
 
 		stbtt_GetFontVMetrics(&font.info, &font.ascent, &font.descent, &font.line_gap);
+		_precompute_flat_kerning_advances(font);
 
 		font.atlas_pixels.resize(ATLAS_TEXTURE_SIZE * ATLAS_TEXTURE_SIZE);
 		stbtt_PackBegin(&font.pack_context, font.atlas_pixels.data(), ATLAS_TEXTURE_SIZE, ATLAS_TEXTURE_SIZE, 0, 1, nullptr);
+		_pack_glyphs(font, U' ', U'~' - U' ' + 1); // Printable ASCII is used by pretty much all text.
 		font.atlas_texture = graphics::create_texture({
 			.debug_name = normalized_path,
 			.width = ATLAS_TEXTURE_SIZE,
@@ -65,7 +215,7 @@ namespace fonts {
 		// font.data/font.atlas_pixels are reallocated and
 		// font.info/font.pack_context are invalidated.
 		const Handle<Font> handle = _font_pool.emplace(std::move(font));
-		_font_path_to_handle[normalized_path] = handle;
+		_font_path_to_handle[key] = handle;
 
 		return handle;
 	}
@@ -73,13 +223,44 @@ namespace fonts {
 	Handle<graphics::Texture> get_atlas_texture(Handle<Font> handle) {
 		Font* font = _font_pool.get(handle);
 		if (!font) return Handle<graphics::Texture>();
-		if (font->atlas_texture_needs_updating) {
-			graphics::update_texture(font->atlas_texture, font->atlas_pixels.data());
-			font->atlas_texture_needs_updating = false;
+		if (font->atlas_dirty_x0 < font->atlas_dirty_x1 && font->atlas_dirty_y0 < font->atlas_dirty_y1) {
+			const int width = font->atlas_dirty_x1 - font->atlas_dirty_x0;
+			const int height = font->atlas_dirty_y1 - font->atlas_dirty_y0;
+			const unsigned char* pixels = font->atlas_pixels.data();
+			if (width != ATLAS_TEXTURE_SIZE) {
+				// The rows of the dirty rectangle aren't contiguous in the atlas, so we pack them first.
+				_atlas_dirty_pixels.resize(width * height);
+				for (int y = 0; y < height; ++y) {
+					memcpy(_atlas_dirty_pixels.data() + y * width,
+						font->atlas_pixels.data() + (font->atlas_dirty_y0 + y) * ATLAS_TEXTURE_SIZE + font->atlas_dirty_x0,
+						width);
+				}
+				pixels = _atlas_dirty_pixels.data();
+			} else {
+				pixels += font->atlas_dirty_y0 * ATLAS_TEXTURE_SIZE;
+			}
+			graphics::update_texture(font->atlas_texture,
+				font->atlas_dirty_x0, font->atlas_dirty_y0, width, height, pixels);
+			font->atlas_dirty_x0 = ATLAS_TEXTURE_SIZE;
+			font->atlas_dirty_y0 = ATLAS_TEXTURE_SIZE;
+			font->atlas_dirty_x1 = 0;
+			font->atlas_dirty_y1 = 0;
 		}
 		return font->atlas_texture;
 	}
 
+	GlyphType get_glyph_type(Handle<Font> handle) {
+		const Font* font = _font_pool.get(handle);
+		if (!font) return GlyphType::Bitmap;
+		return font->glyph_type;
+	}
+
+	int get_ascent(Handle<Font> handle) {
+		const Font* font = _font_pool.get(handle);
+		if (!font) return 0;
+		return font->ascent;
+	}
+
 	int get_line_spacing(Handle<Font> handle) {
 		const Font* font = _font_pool.get(handle);
 		if (!font) return 0;
@@ -95,27 +276,45 @@ namespace fonts {
 	Glyph get_glyph(Handle<Font> handle, char32_t codepoint) {
 		Font* font = _font_pool.get(handle);
 		if (!font) return Glyph();
-		Glyph glyph{};
-		stbtt_GetCodepointHMetrics(&font->info, codepoint, &glyph.advance_width, &glyph.left_side_bearing);
-		stbtt_GetCodepointBox(&font->info, codepoint, &glyph.x0, &glyph.y0, &glyph.x1, &glyph.y1);
-		auto packed_char_it = font->packed_chars.find(codepoint);
-		if (packed_char_it == font->packed_chars.end()) {
-			const float font_size = 30.f; //Hardcoded for now
-			stbtt_packedchar packed_char{};
-			stbtt_PackFontRange(&font->pack_context, font->data.data(), 0, font_size, codepoint, 1, &packed_char);
-			packed_char_it = font->packed_chars.emplace(codepoint, packed_char).first;
-			font->atlas_texture_needs_updating = true;
-		}
-		glyph.s0 = packed_char_it->second.x0;
-		glyph.t0 = packed_char_it->second.y0;
-		glyph.s1 = packed_char_it->second.x1;
-		glyph.t1 = packed_char_it->second.y1;
-		return glyph;
+		if (codepoint < _FLAT_CODEPOINT_COUNT) {
+			if (!font->flat_glyphs_cached[codepoint]) {
+				_pack_glyphs(*font, codepoint, 1);
+			}
+			return font->flat_glyphs[codepoint];
+		}
+		auto it = font->glyphs.find(codepoint);
+		if (it == font->glyphs.end()) {
+			_pack_glyphs(*font, codepoint, 1);
+			it = font->glyphs.find(codepoint);
+		}
+		return it->second;
+	}
+
+	void prewarm_glyphs(Handle<Font> handle, char32_t first_codepoint, unsigned int count) {
+		Font* font = _font_pool.get(handle);
+		if (!font) return;
+		// Pack each run of glyphs that aren't already in the atlas, so we don't pack any glyph twice.
+		const char32_t end_codepoint = first_codepoint + count;
+		char32_t codepoint = first_codepoint;
+		while (codepoint < end_codepoint) {
+			if (_is_glyph_cached(*font, codepoint)) {
+				++codepoint;
+				continue;
+			}
+			const char32_t run_first_codepoint = codepoint;
+			while (codepoint < end_codepoint && !_is_glyph_cached(*font, codepoint)) {
+				++codepoint;
+			}
+			_pack_glyphs(*font, run_first_codepoint, codepoint - run_first_codepoint);
+		}
 	}
 
 	int get_kerning_advance(Handle<Font> handle, char32_t codepoint1, char32_t codepoint2) {
 		const Font* font = _font_pool.get(handle);
 		if (!font) return 0;
+		if (codepoint1 < _FLAT_CODEPOINT_COUNT && codepoint2 < _FLAT_CODEPOINT_COUNT) {
+			return font->flat_kerning_advances[codepoint1 * _FLAT_CODEPOINT_COUNT + codepoint2];
+		}
 		return stbtt_GetCodepointKernAdvance(&font->info, codepoint1, codepoint2);
 	}
 }
\ No newline at end of file
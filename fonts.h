@@ -22,13 +22,28 @@ namespace fonts
 		int t1 = 0;
 	};
 
+	enum class GlyphType
+	{
+		// Coverage bitmaps rasterized at a fixed size. They get blurry when drawn much larger or smaller.
+		Bitmap,
+		// Signed distance fields, sampled with linear filtering and thresholded in the text_sdf_frag shader.
+		// The same atlas entry stays sharp at every pixel height.
+		// Fonts fall back to Bitmap if that shader isn't loaded.
+		SDF,
+	};
+
 	extern const int ATLAS_TEXTURE_SIZE;
 
-	Handle<Font> load_font(const std::string& path);
+	Handle<Font> load_font(const std::string& path, GlyphType glyph_type = GlyphType::Bitmap);
 	Handle<graphics::Texture> get_atlas_texture(Handle<Font> handle); // updates the atlas if it is dirty
+	GlyphType get_glyph_type(Handle<Font> handle);
+	int get_ascent(Handle<Font> handle); // in unscaled coordinates
 	int get_line_spacing(Handle<Font> handle); // in unscaled coordinates
 	float get_scale_for_pixel_height(Handle<Font> handle, float pixel_height);
 	Glyph get_glyph(Handle<Font> handle, char32_t codepoint);
+	// Packs all glyphs in the range [first_codepoint, first_codepoint + count) into the atlas in one batch.
+	// Glyphs are otherwise packed one at a time the first time they're requested by get_glyph().
+	void prewarm_glyphs(Handle<Font> handle, char32_t first_codepoint, unsigned int count);
 	int get_kerning_advance(Handle<Font> handle, char32_t codepoint1, char32_t codepoint2); // in unscaled coordinates
 }
 
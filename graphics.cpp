@@ -38,6 +38,10 @@ namespace graphics {
 		// moved into _path_to_texture. If this map gets cleared for whatever reason,
 		// then all these string_views will therefore be invalidated, so watch out!
 		TextureDesc desc{};
+		// If the texture is a view of one layer of a texture array, this is the array.
+		// Views share the memory of the array, so they don't count towards the memory usage.
+		Handle<Texture> array;
+		unsigned int array_layer = 0;
 	};
 
 	struct Sampler {
@@ -69,9 +73,11 @@ namespace graphics {
 	Pool<FragmentShader> _fragment_shader_pool;
 	Pool<VertexInput> _vertex_input_pool;
 	Pool<Buffer> _buffer_pool;
+	unsigned int _buffers_created = 0;
 	Pool<Texture> _texture_pool;
 	std::unordered_map<std::string, Handle<Texture>> _path_to_texture;
 	unsigned int _total_texture_memory_usage_in_bytes = 0;
+	MipGeneration _mip_generation = MipGeneration::None;
 	Pool<Sampler> _sampler_pool;
 	Pool<Framebuffer> _framebuffer_pool;
 	Handle<Framebuffer> _swap_chain_back_buffer_handle;
@@ -129,6 +135,19 @@ namespace graphics {
 #endif
 		if (!api::initialize(options)) return false;
 
+		// CHOOSE TEXTURE TRANSCODE TARGET
+
+		// Supercompressed KTX2 textures are transcoded to the best block-compressed format the GPU supports.
+		if (api::is_texture_format_supported(Format::BC7_UNORM)) {
+			images::set_transcode_target(images::Compression::BC7);
+		} else if (api::is_texture_format_supported(Format::BC3_UNORM)) {
+			images::set_transcode_target(images::Compression::BC3);
+		} else if (api::is_texture_format_supported(Format::ETC2_RGBA8_UNORM)) {
+			images::set_transcode_target(images::Compression::ETC2);
+		} else {
+			images::set_transcode_target(images::Compression::None);
+		}
+
 		// INITIALIZE SWAP CHAIN BACK BUFFER
 
 		Framebuffer swap_chain_back_buffer{};
@@ -290,6 +309,16 @@ namespace graphics {
 		return _vertex_shader_pool.emplace(api_handle);
 	}
 
+	bool recreate_vertex_shader(Handle<VertexShader> handle, ShaderDesc&& desc) {
+		VertexShader* shader = _vertex_shader_pool.get(handle);
+		if (!shader) return false;
+		api::VertexShaderHandle api_handle = api::create_vertex_shader(desc);
+		if (!api_handle.object) return false;
+		api::destroy_vertex_shader(shader->api_handle);
+		shader->api_handle = api_handle;
+		return true;
+	}
+
 	void bind_vertex_shader(Handle<VertexShader> handle) {
 		if (handle == Handle<VertexShader>()) {
 			api::bind_vertex_shader(api::VertexShaderHandle());
@@ -304,6 +333,16 @@ namespace graphics {
 		return _fragment_shader_pool.emplace(api_handle);
 	}
 
+	bool recreate_fragment_shader(Handle<FragmentShader> handle, ShaderDesc&& desc) {
+		FragmentShader* shader = _fragment_shader_pool.get(handle);
+		if (!shader) return false;
+		api::FragmentShaderHandle api_handle = api::create_fragment_shader(desc);
+		if (!api_handle.object) return false;
+		api::destroy_fragment_shader(shader->api_handle);
+		shader->api_handle = api_handle;
+		return true;
+	}
+
 	void bind_fragment_shader(Handle<FragmentShader> handle) {
 		if (handle == Handle<FragmentShader>()) {
 			api::bind_fragment_shader(api::FragmentShaderHandle());
@@ -329,6 +368,7 @@ namespace graphics {
 	Handle<Buffer> create_buffer(BufferDesc&& desc) {
 		api::BufferHandle api_handle = api::create_buffer(desc);
 		if (!api_handle.object) return Handle<Buffer>();
+		++_buffers_created;
 		desc.initial_data = nullptr;
 		return _buffer_pool.emplace(api_handle, std::move(desc));
 	}
@@ -341,6 +381,7 @@ namespace graphics {
 		buffer->desc.initial_data = initial_data;
 		buffer->api_handle = api::create_buffer(buffer->desc);
 		buffer->desc.initial_data = nullptr;
+		++_buffers_created;
 	}
 
 	void destroy_buffer(Handle<Buffer> handle) {
@@ -360,6 +401,15 @@ namespace graphics {
 		api::update_buffer(buffer->api_handle, data, size, offset);
 	}
 
+	void update_buffer_no_overwrite(Handle<Buffer> handle, const void* data, unsigned int size, unsigned int offset) {
+		if (!data || !size) return;
+		Buffer* buffer = _buffer_pool.get(handle);
+		if (!buffer) return;
+		if (!buffer->desc.dynamic) return;
+		if (offset + size > buffer->desc.size) return;
+		api::update_buffer_no_overwrite(buffer->api_handle, data, size, offset);
+	}
+
 	size_t get_buffer_size(Handle<Buffer> handle) {
 		if (const Buffer* buffer = _buffer_pool.get(handle)) {
 			return buffer->desc.size;
@@ -367,6 +417,10 @@ namespace graphics {
 		return 0;
 	}
 
+	unsigned int get_buffers_created() {
+		return _buffers_created;
+	}
+
 	void bind_vertex_buffer(unsigned int binding, Handle<Buffer> handle, unsigned int stride, unsigned int offset) {
 		if (handle == Handle<Buffer>()) {
 			api::bind_vertex_buffer(binding, api::BufferHandle(), 0, 0);
@@ -408,11 +462,51 @@ namespace graphics {
 		}
 	}
 
+	bool _is_block_compressed_format(Format format) {
+		return format == Format::BC3_UNORM || format == Format::BC7_UNORM || format == Format::ETC2_RGBA8_UNORM;
+	}
+
+	// Returns the number of mip levels in a full mip chain, down to 1x1.
+	unsigned int _get_full_mip_count(unsigned int width, unsigned int height) {
+		unsigned int count = 1;
+		while ((width | height) > 1) {
+			width /= 2;
+			height /= 2;
+			count++;
+		}
+		return count;
+	}
+
+	unsigned int _get_level_byte_size(Format format, unsigned int width, unsigned int height) {
+		if (_is_block_compressed_format(format)) {
+			return ((width + 3) / 4) * ((height + 3) / 4) * 16;
+		}
+		return width * height * _format_to_channels(format);
+	}
+
+	// Includes all mip levels and array layers.
 	unsigned int _get_texture_byte_size(const TextureDesc& desc) {
-		return desc.width * desc.height * _format_to_channels(desc.format);
+		unsigned int size = 0;
+		for (unsigned int level = 0; level < desc.mip_levels; ++level) {
+			size += _get_level_byte_size(desc.format, std::max(desc.width >> level, 1u), std::max(desc.height >> level, 1u));
+		}
+		return size * desc.array_layers;
+	}
+
+	// Returns the size the texture would have as uncompressed RGBA8, which is what block-compressed textures are decoded from.
+	unsigned int _get_uncompressed_texture_byte_size(const TextureDesc& desc) {
+		if (_is_block_compressed_format(desc.format)) {
+			TextureDesc uncompressed_desc = desc;
+			uncompressed_desc.format = Format::RGBA8_UNORM;
+			return _get_texture_byte_size(uncompressed_desc);
+		}
+		return _get_texture_byte_size(desc);
 	}
 
 	Handle<Texture> create_texture(TextureDesc&& desc) {
+		if (desc.mip_levels == 0) {
+			desc.mip_levels = _get_full_mip_count(desc.width, desc.height);
+		}
 		api::TextureHandle api_handle = api::create_texture(desc);
 		if (!api_handle.object) return Handle<Texture>();
 		desc.initial_data = nullptr;
@@ -430,7 +524,18 @@ namespace graphics {
 		}
 	}
 
-	Handle<Texture> load_texture(const std::string& path) {
+	Format _image_to_format(const images::Image& image) {
+		switch (image.compression) {
+		case images::Compression::BC3:  return Format::BC3_UNORM;
+		case images::Compression::BC7:  return Format::BC7_UNORM;
+		case images::Compression::ETC2: return Format::ETC2_RGBA8_UNORM;
+		default: return _channels_to_format(image.channels);
+		}
+	}
+
+	// Returns the texture if it is already loaded. Otherwise, sets path_to_load to the file the texture
+	// should be loaded from, or leaves it empty if there is no such file.
+	Handle<Texture> _find_texture_or_path_to_load(const std::string& path, std::string& path_to_load) {
 
 		std::string normalized_path = filesystem::get_normalized_path(path);
 		// KTX2 compressed textures load much MUCH faster, so we prefer those whenever possible.
@@ -445,31 +550,59 @@ namespace graphics {
 			return it->second;
 		}
 
-		images::Image image{};
-		std::string path_used;
-		
 		if (filesystem::file_exists(normalized_path_ktx2)) {
 			// Try to load a KTX2 texture first if it exists.
-			if (!images::load_image(normalized_path_ktx2, image)) {
-				return Handle<Texture>();
-			}
-			path_used = std::move(normalized_path_ktx2);
+			path_to_load = std::move(normalized_path_ktx2);
 		} else if (filesystem::file_exists(normalized_path)) {
 			// Fall back to loading the non-KTX2 texture.
-			if (!images::load_image(normalized_path, image)) {
-				return Handle<Texture>();
-			}
-			path_used = std::move(normalized_path);
+			path_to_load = std::move(normalized_path);
 		} else {
 			console::log_error("Failed to load texture: " + normalized_path);
-			return Handle<Texture>();
 		}
+		return Handle<Texture>();
+	}
+
+	unsigned int _get_mip_levels_for_image(const images::Image& image) {
+		// SIC: Block-compressed images can't be downsampled without decoding them first.
+		if (_mip_generation == MipGeneration::None || image.compression != images::Compression::None) return 1;
+		return 0; // full mip chain
+	}
+
+	// Uploads the mip levels below the first one of a texture layer, by downsampling the image on the CPU.
+	void _upload_mips(const Texture& texture, unsigned int layer, const images::Image& image) {
+		images::Image previous_mip{};
+		for (unsigned int level = 1; level < texture.desc.mip_levels; ++level) {
+			images::Image mip{};
+			if (!images::generate_mip(level == 1 ? image : previous_mip, mip)) break;
+			api::update_texture(texture.api_handle, level, layer, 0, 0, mip.width, mip.height, texture.desc.format, mip.data);
+			images::free_image(previous_mip);
+			previous_mip = mip;
+		}
+		images::free_image(previous_mip);
+	}
 
-		const Format format = _channels_to_format(image.channels);
+	// Fills the mip levels below the first one, using the method set with set_mip_generation().
+	// The image is what the first level of the layer was created from.
+	void _fill_mips(const Texture& texture, unsigned int layer, const images::Image& image) {
+		if (texture.desc.mip_levels <= 1) return;
+		if (_mip_generation == MipGeneration::Gpu) {
+			api::generate_mips(texture.api_handle);
+		} else {
+			_upload_mips(texture, layer, image);
+		}
+	}
+
+	void _log_unsupported_image_format(std::string_view path, const images::Image& image) {
+		console::log_error("Unsupported texture channel count:");
+		console::log_error("- Texture: " + std::string(path));
+		console::log_error("- Channels: " + std::to_string(image.channels));
+	}
+
+	// Creates a texture from a decoded image and frees the image.
+	Handle<Texture> _create_texture_from_image(std::string&& path_used, images::Image& image) {
+		const Format format = _image_to_format(image);
 		if (format == Format::UNKNOWN) {
-			console::log_error("Unsupported texture channel count:");
-			console::log_error("- Texture: " + std::string(path_used));
-			console::log_error("- Channels: " + std::to_string(image.channels));
+			_log_unsupported_image_format(path_used, image);
 			images::free_image(image); // Don't forget!
 			return Handle<Texture>();
 		}
@@ -484,8 +617,12 @@ namespace graphics {
 			.width = image.width,
 			.height = image.height,
 			.format = format,
+			.mip_levels = _get_mip_levels_for_image(image),
 			.initial_data = image.data
 		});
+		if (const Texture* texture = _texture_pool.get(handle)) {
+			_fill_mips(*texture, 0, image);
+		}
 
 		images::free_image(image); // Don't forget!
 
@@ -495,6 +632,203 @@ namespace graphics {
 		return handle;
 	}
 
+	// Creates a texture array with one layer per image, plus a view of each layer that is registered
+	// under the image's path, and frees the images. The images must all have the same size and format.
+	// Returns false without freeing anything if the graphics API doesn't support layer views.
+	bool _create_texture_array_from_images(std::span<std::string*> paths_used, std::span<images::Image*> images,
+		std::span<Handle<Texture>> handles) {
+		const images::Image& first_image = *images[0];
+		const Handle<Texture> array_handle = create_texture({
+			.debug_name = "texture array",
+			.width = first_image.width,
+			.height = first_image.height,
+			.format = _image_to_format(first_image),
+			.mip_levels = _get_mip_levels_for_image(first_image),
+			.array_layers = (unsigned int)images.size()
+		});
+		const Texture* array = _texture_pool.get(array_handle);
+		if (!array) return false;
+
+		const api::TextureHandle first_view = api::create_texture_layer_view(array->api_handle, array->desc, 0);
+		if (!first_view.object) {
+			destroy_texture(array_handle);
+			return false;
+		}
+
+		for (unsigned int layer = 0; layer < images.size(); ++layer) {
+			images::Image& image = *images[layer];
+			api::update_texture(array->api_handle, 0, layer, 0, 0, image.width, image.height, array->desc.format, image.data);
+			if (_mip_generation == MipGeneration::Cpu) {
+				_upload_mips(*array, layer, image);
+			}
+			images::free_image(image); // Don't forget!
+		}
+		if (_mip_generation == MipGeneration::Gpu && array->desc.mip_levels > 1) {
+			api::generate_mips(array->api_handle);
+		}
+
+		for (unsigned int layer = 0; layer < images.size(); ++layer) {
+			std::string& path_used = *paths_used[layer];
+			TextureDesc view_desc = array->desc;
+			view_desc.debug_name = path_used; // PITFALL: See _create_texture_from_image().
+			view_desc.array_layers = 1;
+			// PITFALL: Emplacing may reallocate the pool, so we can't hold on to the array pointer.
+			const api::TextureHandle view = layer ? api::create_texture_layer_view(array->api_handle, array->desc, layer) : first_view;
+			handles[layer] = _texture_pool.emplace(view, view_desc, array_handle, layer);
+			array = _texture_pool.get(array_handle);
+			// CRITICAL: Move path_used so it is kept alive.
+			_path_to_texture[std::move(path_used)] = handles[layer];
+		}
+		return true;
+	}
+
+	Handle<Texture> load_texture(const std::string& path) {
+		std::string path_to_load;
+		if (const Handle<Texture> handle = _find_texture_or_path_to_load(path, path_to_load); handle != Handle<Texture>()) {
+			return handle;
+		}
+		if (path_to_load.empty()) return Handle<Texture>();
+		images::Image image{};
+		if (!images::load_image(path_to_load, image)) {
+			return Handle<Texture>();
+		}
+		return _create_texture_from_image(std::move(path_to_load), image);
+	}
+
+	std::vector<Handle<Texture>> _load_textures(std::span<const std::string> paths, bool into_arrays) {
+		std::vector<Handle<Texture>> handles(paths.size());
+		std::vector<std::string> paths_to_load;
+		std::vector<size_t> load_indices(paths.size(), SIZE_MAX); // index into paths_to_load for each path
+		for (size_t i = 0; i < paths.size(); ++i) {
+			std::string path_to_load;
+			handles[i] = _find_texture_or_path_to_load(paths[i], path_to_load);
+			if (path_to_load.empty()) continue;
+			// SIC: The same texture may be requested more than once, but we only want to decode it once.
+			const auto it = std::ranges::find(paths_to_load, path_to_load);
+			load_indices[i] = it - paths_to_load.begin();
+			if (it == paths_to_load.end()) {
+				paths_to_load.push_back(std::move(path_to_load));
+			}
+		}
+
+		std::vector<images::Image> images(paths_to_load.size());
+		images::load_images(paths_to_load, images);
+
+		std::vector<Handle<Texture>> loaded_handles(paths_to_load.size());
+		if (into_arrays) {
+			// Group the images by size and format. Groups of more than one image become texture arrays.
+			std::vector<std::string*> group_paths;
+			std::vector<images::Image*> group_images;
+			std::vector<Handle<Texture>> group_handles;
+			for (size_t i = 0; i < paths_to_load.size(); ++i) {
+				if (!images[i].data) continue;
+				const Format format = _image_to_format(images[i]);
+				if (format == Format::UNKNOWN) continue; // Logged when creating the texture below.
+				group_paths.clear();
+				group_images.clear();
+				for (size_t j = i; j < paths_to_load.size(); ++j) {
+					if (!images[j].data) continue;
+					if (images[j].width != images[i].width || images[j].height != images[i].height) continue;
+					if (_image_to_format(images[j]) != format) continue;
+					group_paths.push_back(&paths_to_load[j]);
+					group_images.push_back(&images[j]);
+				}
+				if (group_images.size() < 2) continue;
+				group_handles.assign(group_images.size(), Handle<Texture>());
+				if (!_create_texture_array_from_images(group_paths, group_images, group_handles)) break;
+				for (size_t k = 0; k < group_images.size(); ++k) {
+					loaded_handles[group_images[k] - images.data()] = group_handles[k];
+				}
+			}
+		}
+
+		// Upload the textures in submission order, so the result is the same as calling load_texture() in a loop.
+		for (size_t i = 0; i < paths_to_load.size(); ++i) {
+			if (!images[i].data) continue; // The error has already been logged, or the image went into an array.
+			loaded_handles[i] = _create_texture_from_image(std::move(paths_to_load[i]), images[i]);
+		}
+		for (size_t i = 0; i < paths.size(); ++i) {
+			if (load_indices[i] != SIZE_MAX) {
+				handles[i] = loaded_handles[load_indices[i]];
+			}
+		}
+		return handles;
+	}
+
+	std::vector<Handle<Texture>> load_textures(std::span<const std::string> paths) {
+		return _load_textures(paths, false);
+	}
+
+	std::vector<Handle<Texture>> load_texture_arrays(std::span<const std::string> paths) {
+		// Without layer views, the layers couldn't be used like separate textures, so we don't create arrays at all.
+		if (!api::are_texture_layer_views_supported()) return _load_textures(paths, false);
+		return _load_textures(paths, true);
+	}
+
+	bool get_texture_array_layer(Handle<Texture> handle, Handle<Texture>& array, unsigned int& layer) {
+		const Texture* texture = _texture_pool.get(handle);
+		if (!texture || texture->array == Handle<Texture>()) return false;
+		array = texture->array;
+		layer = texture->array_layer;
+		return true;
+	}
+
+	void set_mip_generation(MipGeneration mip_generation) {
+		_mip_generation = mip_generation;
+	}
+
+	void generate_mips(Handle<Texture> handle) {
+		const Texture* texture = _texture_pool.get(handle);
+		if (!texture || texture->desc.mip_levels <= 1) return;
+		if (_is_block_compressed_format(texture->desc.format)) return;
+		api::generate_mips(texture->api_handle);
+	}
+
+	bool reload_texture(const std::string& path) {
+		const auto it = _path_to_texture.find(filesystem::get_normalized_path(path));
+		if (it == _path_to_texture.end()) return false;
+		Texture* texture = _texture_pool.get(it->second);
+		if (!texture) return false;
+
+		images::Image image{};
+		if (!images::load_image(it->first, image)) return false;
+		const Format format = _image_to_format(image);
+		if (format == Format::UNKNOWN) {
+			_log_unsupported_image_format(it->first, image);
+			images::free_image(image); // Don't forget!
+			return false;
+		}
+
+		if (image.width == texture->desc.width && image.height == texture->desc.height && format == texture->desc.format) {
+			// SIC: If the texture is a layer view, this writes into the layer of the array it shares memory with.
+			update_texture(it->second, (const unsigned char*)image.data);
+		} else {
+			// The size or format changed, so we recreate the API texture under the same handle.
+			// If it was a layer view, it becomes a standalone texture.
+			api::destroy_texture(texture->api_handle);
+			if (texture->array == Handle<Texture>()) {
+				_total_texture_memory_usage_in_bytes -= _get_texture_byte_size(texture->desc);
+			}
+			texture->array = Handle<Texture>();
+			texture->array_layer = 0;
+			texture->desc.width = image.width;
+			texture->desc.height = image.height;
+			texture->desc.format = format;
+			texture->desc.mip_levels = _get_mip_levels_for_image(image);
+			if (texture->desc.mip_levels == 0) {
+				texture->desc.mip_levels = _get_full_mip_count(image.width, image.height);
+			}
+			texture->desc.initial_data = image.data;
+			texture->api_handle = api::create_texture(texture->desc);
+			texture->desc.initial_data = nullptr;
+			_total_texture_memory_usage_in_bytes += _get_texture_byte_size(texture->desc);
+		}
+		_fill_mips(*texture, 0, image);
+
+		images::free_image(image); // Don't forget!
+		return true;
+	}
+
 	Handle<Texture> copy_texture(Handle<Texture> src) {
 		Handle<Texture> dest;
 		if (const Texture* src_texture = _texture_pool.get(src)) {
@@ -508,7 +842,9 @@ namespace graphics {
 		Texture* texture = _texture_pool.get(handle);
 		if (!texture) return;
 		api::destroy_texture(texture->api_handle);
-		_total_texture_memory_usage_in_bytes -= _get_texture_byte_size(texture->desc);
+		if (texture->array == Handle<Texture>()) {
+			_total_texture_memory_usage_in_bytes -= _get_texture_byte_size(texture->desc);
+		}
 		// HACK: When a texture is loaded, its debug_name is set to the path.
 		_path_to_texture.erase(std::string(texture->desc.debug_name));
 		*texture = Texture();
@@ -526,10 +862,18 @@ namespace graphics {
 	void update_texture(Handle<Texture> handle, const unsigned char* data) {
 		const Texture* texture = _texture_pool.get(handle);
 		if (!texture) return;
-		api::update_texture(texture->api_handle, 0, 0, 0,
+		api::update_texture(texture->api_handle, 0, 0, 0, 0,
 			texture->desc.width, texture->desc.height, texture->desc.format, data);
 	}
 
+	void update_texture(Handle<Texture> handle, unsigned int x, unsigned int y,
+		unsigned int width, unsigned int height, const unsigned char* data) {
+		const Texture* texture = _texture_pool.get(handle);
+		if (!texture) return;
+		if (x + width > texture->desc.width || y + height > texture->desc.height) return;
+		api::update_texture(texture->api_handle, 0, 0, x, y, width, height, texture->desc.format, data);
+	}
+
 	void copy_texture(Handle<Texture> dest, Handle<Texture> src) {
 		Texture* dest_texture = _texture_pool.get(dest);
 		const Texture* src_texture = _texture_pool.get(src);
@@ -711,20 +1055,42 @@ namespace graphics {
 		api::draw(vertex_count, vertex_offset);
 	}
 
-	void draw_indexed(unsigned int index_count) {
-		api::draw_indexed(index_count);
+	void draw_indexed(unsigned int index_count, unsigned int index_offset, unsigned int base_vertex) {
+		api::draw_indexed(index_count, index_offset, base_vertex);
 	}
 
 	void show_texture_debug_window() {
 #ifdef _DEBUG_IMGUI
 		ImGui::Begin("Textures");
 		ImGui::Text("Total memory usage: %d MB", _total_texture_memory_usage_in_bytes / 1024 / 1024);
+		unsigned int total_uncompressed_size = 0;
+		for (const Texture& texture : _texture_pool.span()) {
+			if (!texture.api_handle.object) continue;
+			if (texture.array != Handle<Texture>()) continue; // views share the array's memory
+			total_uncompressed_size += _get_uncompressed_texture_byte_size(texture.desc);
+		}
+		// This is also how much less data block compression uploads to the GPU.
+		ImGui::Text("Saved by compression: %d MB", (total_uncompressed_size - _total_texture_memory_usage_in_bytes) / 1024 / 1024);
 		for (size_t i = 0; i < _texture_pool.size(); ++i) {
 			const Texture& texture = _texture_pool.data()[i];
 			if (!texture.api_handle.object) continue;
 			if (ImGui::TreeNode(texture.desc.debug_name.data())) {
 				ImGui::Text("Dimensions: %dx%dx", texture.desc.width, texture.desc.height);
 				ImGui::Text("Format: %s", magic_enum::enum_name(texture.desc.format).data());
+				if (texture.desc.mip_levels > 1) {
+					ImGui::Text("Mip levels: %d", texture.desc.mip_levels);
+				}
+				if (texture.desc.array_layers > 1) {
+					ImGui::Text("Array layers: %d", texture.desc.array_layers);
+				}
+				if (texture.array != Handle<Texture>()) {
+					// Views share the array's memory, so we show the layer instead.
+					ImGui::Text("Array layer: %d", texture.array_layer);
+					ImVec2 texture_size = ImVec2((float)texture.desc.width, (float)texture.desc.height);
+					ImGui::Image((ImTextureID)texture.api_handle.object, texture_size);
+					ImGui::TreePop();
+					continue;
+				}
 				unsigned int size = _get_texture_byte_size(texture.desc);
 				unsigned int kb = size / 1024;
 				unsigned int mb = kb / 1024;
@@ -733,8 +1099,14 @@ namespace graphics {
 				} else {
 					ImGui::Text("Memory: %d KB", kb);
 				}
-				ImVec2 texture_size = ImVec2((float)texture.desc.width, (float)texture.desc.height);
-				ImGui::Image((ImTextureID)texture.api_handle.object, texture_size);
+				if (_is_block_compressed_format(texture.desc.format)) {
+					ImGui::Text("Uncompressed: %d KB", _get_uncompressed_texture_byte_size(texture.desc) / 1024);
+				}
+				// SIC: ImGui can only draw 2D textures, so arrays are shown through their layer views.
+				if (texture.desc.array_layers == 1) {
+					ImVec2 texture_size = ImVec2((float)texture.desc.width, (float)texture.desc.height);
+					ImGui::Image((ImTextureID)texture.api_handle.object, texture_size);
+				}
 				ImGui::TreePop();
 			}
 		}
@@ -35,10 +35,14 @@ namespace graphics {
 	};
 
 	Handle<VertexShader> create_vertex_shader(ShaderDesc&& desc);
+	// Replaces the shader in place, so existing handles stay valid. Keeps the old shader on failure.
+	bool recreate_vertex_shader(Handle<VertexShader> handle, ShaderDesc&& desc);
 	// Pass an empty handle to unbind any currently bound vertex shader.
 	void bind_vertex_shader(Handle<VertexShader> handle);
 
 	Handle<FragmentShader> create_fragment_shader(ShaderDesc&& desc);
+	// Replaces the shader in place, so existing handles stay valid. Keeps the old shader on failure.
+	bool recreate_fragment_shader(Handle<FragmentShader> handle, ShaderDesc&& desc);
 	// Pass an empty handle to unbind any currently bound fragment shader.
 	void bind_fragment_shader(Handle<FragmentShader> handle);
 
@@ -50,7 +54,11 @@ namespace graphics {
 	void destroy_buffer(Handle<Buffer> handle);
 	// Fails if the buffer is not dynamic, or if offset + size exceeds the buffer size.
 	void update_buffer(Handle<Buffer> handle, const void* data, unsigned int size, unsigned int offset = 0);
+	// Like update_buffer(), but the rest of the buffer keeps its contents. The caller must make sure
+	// the GPU is no longer reading the updated range. Only supported for vertex and index buffers.
+	void update_buffer_no_overwrite(Handle<Buffer> handle, const void* data, unsigned int size, unsigned int offset);
 	size_t get_buffer_size(Handle<Buffer> handle);
+	unsigned int get_buffers_created(); // Total since initialization, including recreated buffers.
 	// Pass an empty handle to unbind any currently bound buffer.
 	void bind_vertex_buffer(unsigned int binding, Handle<Buffer> handle, unsigned int stride, unsigned int offset = 0);
 	// Pass an empty handle to unbind any currently bound buffer.
@@ -63,11 +71,34 @@ namespace graphics {
 
 	Handle<Texture> create_texture(TextureDesc&& desc);
 	Handle<Texture> load_texture(const std::string& path);
+	// Same as calling load_texture() for each path, but decodes the images in parallel.
+	std::vector<Handle<Texture>> load_textures(std::span<const std::string> paths);
+	// Same as load_textures(), but images with the same size and format are put into one texture array.
+	// The returned handles are views of the array layers, usable like any other texture.
+	// If the graphics API doesn't support layer views, this is the same as load_textures().
+	std::vector<Handle<Texture>> load_texture_arrays(std::span<const std::string> paths);
+	// Returns false if the texture isn't a view of a texture array layer.
+	bool get_texture_array_layer(Handle<Texture> handle, Handle<Texture>& array, unsigned int& layer);
+	enum class MipGeneration {
+		None, // only the first level
+		Cpu, // box-filtered on the CPU and uploaded
+		Gpu, // generated by the graphics API
+	};
+	// Applies to textures loaded from files after this call. Block-compressed textures never get mips.
+	void set_mip_generation(MipGeneration mip_generation);
+	// Regenerates the mips of a texture created with more than one mip level, on the GPU.
+	void generate_mips(Handle<Texture> handle);
+	// Reloads a texture previously loaded from the path, updating it in place so that existing
+	// handles stay valid. Returns false if no texture was loaded from the path.
+	bool reload_texture(const std::string& path);
 	Handle<Texture> copy_texture(Handle<Texture> src);
 	void destroy_texture(Handle<Texture> handle);
 	// Pass an empty handle to unbind any currently bound texture.
 	void bind_texture(unsigned int binding, Handle<Texture> handle);
 	void update_texture(Handle<Texture> handle, const unsigned char* data);
+	// Updates a subrectangle of the texture. The data must be tightly packed, i.e. have a row pitch of width.
+	void update_texture(Handle<Texture> handle, unsigned int x, unsigned int y,
+		unsigned int width, unsigned int height, const unsigned char* data);
 	void copy_texture(Handle<Texture> dest, Handle<Texture> src);
 	void get_texture_size(Handle<Texture> handle, unsigned int& width, unsigned int& height);
 
@@ -100,7 +131,7 @@ namespace graphics {
 	bool get_scissor_test_enabled();
 
 	void draw(unsigned int vertex_count, unsigned int vertex_offset = 0);
-	void draw_indexed(unsigned int index_count);
+	void draw_indexed(unsigned int index_count, unsigned int index_offset = 0, unsigned int base_vertex = 0);
 
 	void show_texture_debug_window();
 }
\ No newline at end of file
@@ -36,6 +36,8 @@ namespace api {
 	void shutdown();
 
 	bool is_spirv_supported();
+	bool is_texture_format_supported(Format format);
+	bool are_texture_layer_views_supported();
 
 #ifdef GRAPHICS_API_D3D11
 	ID3D11Device* get_d3d11_device();
@@ -70,6 +72,7 @@ namespace api {
 	BufferHandle create_buffer(const BufferDesc& desc);
 	void destroy_buffer(BufferHandle buffer);
 	void update_buffer(BufferHandle buffer, const void* data, unsigned int size, unsigned int offset);
+	void update_buffer_no_overwrite(BufferHandle buffer, const void* data, unsigned int size, unsigned int offset);
 	void bind_uniform_buffer(unsigned int binding, BufferHandle buffer);
 	void bind_uniform_buffer_range(unsigned int binding, BufferHandle buffer, unsigned int size, unsigned int offset);
 	void bind_vertex_buffer(unsigned int binding, BufferHandle buffer, unsigned int stride, unsigned int offset);
@@ -77,11 +80,18 @@ namespace api {
 
 	struct TextureHandle { uintptr_t object = 0; };
 
+	// PITFALL: desc.mip_levels must not be 0 here, since the backends don't compute the full mip count.
 	TextureHandle create_texture(const TextureDesc& desc);
+	// Creates a 2D texture that shares its storage with one layer of a texture array.
+	// Returns an empty handle if are_texture_layer_views_supported() returns false.
+	TextureHandle create_texture_layer_view(TextureHandle array_texture, const TextureDesc& array_desc, unsigned int layer);
 	void destroy_texture(TextureHandle texture);
+	// Fills the mip levels below the first one by downsampling it. Not supported for block-compressed formats.
+	void generate_mips(TextureHandle texture);
 	void update_texture(
 		TextureHandle texture,
 		unsigned int level,
+		unsigned int layer,
 		unsigned int x,
 		unsigned int y,
 		unsigned int width,
@@ -137,7 +147,7 @@ namespace api {
 	void set_primitives(Primitives primitives);
 
 	void draw(unsigned int vertex_count, unsigned int vertex_offset = 0);
-	void draw_indexed(unsigned int index_count, unsigned int base_vertex = 0);
+	void draw_indexed(unsigned int index_count, unsigned int index_offset = 0, unsigned int base_vertex = 0);
 
 } // namespace api
 } // namespace graphics
\ No newline at end of file
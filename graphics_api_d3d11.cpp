@@ -418,7 +418,9 @@ namespace api {
 		case Format::RG32_FLOAT:   return DXGI_FORMAT_R32G32_FLOAT;
 		case Format::RGB32_FLOAT:  return DXGI_FORMAT_R32G32B32_FLOAT;
 		case Format::RGBA32_FLOAT: return DXGI_FORMAT_R32G32B32A32_FLOAT;
-		default:                   return DXGI_FORMAT_UNKNOWN;
+		case Format::BC3_UNORM:    return DXGI_FORMAT_BC3_UNORM;
+		case Format::BC7_UNORM:    return DXGI_FORMAT_BC7_UNORM;
+		default:                   return DXGI_FORMAT_UNKNOWN; // D3D11 doesn't support ETC2
 		}
 	}
 
@@ -527,6 +529,21 @@ namespace api {
 		_device_context->Unmap(d3d11_buffer, 0);
 	}
 
+	void update_buffer_no_overwrite(BufferHandle buffer, const void* data, unsigned int size, unsigned int offset) {
+		if (!buffer.object) return;
+		ID3D11Buffer* d3d11_buffer = (ID3D11Buffer*)buffer.object;
+		D3D11_MAPPED_SUBRESOURCE d3d11_mapped_subresource{};
+		// PITFALL: D3D11_MAP_WRITE_NO_OVERWRITE is only allowed on constant buffers from D3D 11.1,
+		// so only use this function on vertex and index buffers.
+		HRESULT result = _device_context->Map(d3d11_buffer, 0, D3D11_MAP_WRITE_NO_OVERWRITE, 0, &d3d11_mapped_subresource);
+		if (FAILED(result)) {
+			_output_debug_message("Failed to map buffer");
+			return;
+		}
+		memcpy((void*)((uintptr_t)d3d11_mapped_subresource.pData + offset), data, size);
+		_device_context->Unmap(d3d11_buffer, 0);
+	}
+
 	void bind_uniform_buffer(unsigned int binding, BufferHandle buffer) {
 		// SIC: Allow binding a null buffer to unbind the current buffer.
 		ID3D11Buffer* d3d11_buffer = (ID3D11Buffer*)buffer.object;
@@ -577,12 +594,35 @@ namespace api {
 		}
 	}
 
+	bool _is_block_compressed_format(Format format) {
+		return format == Format::BC3_UNORM || format == Format::BC7_UNORM || format == Format::ETC2_RGBA8_UNORM;
+	}
+
+	// Returns the number of bytes between rows of pixels, or rows of 4x4 blocks for block-compressed formats.
+	UINT _get_row_pitch(Format format, UINT width) {
+		switch (format) {
+		case Format::BC3_UNORM:
+		case Format::BC7_UNORM:
+			return ((width + 3) / 4) * 16;
+		default:
+			return width * _format_to_byte_width(format);
+		}
+	}
+
+	bool is_texture_format_supported(Format format) {
+		const DXGI_FORMAT dxgi_format = _format_to_dxgi_format(format);
+		if (dxgi_format == DXGI_FORMAT_UNKNOWN) return false;
+		UINT support = 0;
+		if (FAILED(_device->CheckFormatSupport(dxgi_format, &support))) return false;
+		return (support & D3D11_FORMAT_SUPPORT_TEXTURE2D) != 0;
+	}
+
 	TextureHandle create_texture(const TextureDesc& desc) {
 		D3D11_TEXTURE2D_DESC d3d11_texture2d_desc{};
 		d3d11_texture2d_desc.Width = desc.width;
 		d3d11_texture2d_desc.Height = desc.height;
-		d3d11_texture2d_desc.MipLevels = 1;
-		d3d11_texture2d_desc.ArraySize = 1;
+		d3d11_texture2d_desc.MipLevels = desc.mip_levels;
+		d3d11_texture2d_desc.ArraySize = desc.array_layers;
 		d3d11_texture2d_desc.Format = _format_to_dxgi_format(desc.format);
 		d3d11_texture2d_desc.SampleDesc.Count = 1;
 		d3d11_texture2d_desc.Usage = D3D11_USAGE_DEFAULT; // D3D11_USAGE_IMMUTABLE?
@@ -590,12 +630,20 @@ namespace api {
 		if (desc.framebuffer_color) {
 			d3d11_texture2d_desc.BindFlags |= D3D11_BIND_RENDER_TARGET;
 		}
+		if (desc.mip_levels > 1 && !_is_block_compressed_format(desc.format)) {
+			// GenerateMips() requires the texture to be a render target.
+			d3d11_texture2d_desc.BindFlags |= D3D11_BIND_RENDER_TARGET;
+			d3d11_texture2d_desc.MiscFlags |= D3D11_RESOURCE_MISC_GENERATE_MIPS;
+		}
 		HRESULT result = S_OK;
 		Microsoft::WRL::ComPtr<ID3D11Texture2D> d3d11_texture2d{};
-		if (desc.initial_data) {
+		// PITFALL: Initial data has to be given for every subresource, so for textures
+		// with several of them, we create the texture empty and upload the first one below.
+		const bool has_one_subresource = (desc.mip_levels == 1 && desc.array_layers == 1);
+		if (desc.initial_data && has_one_subresource) {
 			D3D11_SUBRESOURCE_DATA d3d11_initial_data{};
 			d3d11_initial_data.pSysMem = desc.initial_data;
-			d3d11_initial_data.SysMemPitch = desc.width * _format_to_byte_width(desc.format);
+			d3d11_initial_data.SysMemPitch = _get_row_pitch(desc.format, desc.width);
 			result = _device->CreateTexture2D(&d3d11_texture2d_desc, &d3d11_initial_data, &d3d11_texture2d);
 		} else {
 			result = _device->CreateTexture2D(&d3d11_texture2d_desc, nullptr, &d3d11_texture2d);
@@ -605,11 +653,23 @@ namespace api {
 			return TextureHandle();
 		}
 		_set_debug_name(d3d11_texture2d.Get(), desc.debug_name);
+		if (desc.initial_data && !has_one_subresource) {
+			_device_context->UpdateSubresource(d3d11_texture2d.Get(), 0, nullptr, desc.initial_data,
+				_get_row_pitch(desc.format, desc.width), 0);
+		}
 		D3D11_SHADER_RESOURCE_VIEW_DESC d3d11_srv_desc{};
 		d3d11_srv_desc.Format = d3d11_texture2d_desc.Format;
-		d3d11_srv_desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-		d3d11_srv_desc.Texture2D.MostDetailedMip = 0;
-		d3d11_srv_desc.Texture2D.MipLevels = 1;
+		if (desc.array_layers > 1) {
+			d3d11_srv_desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+			d3d11_srv_desc.Texture2DArray.MostDetailedMip = 0;
+			d3d11_srv_desc.Texture2DArray.MipLevels = desc.mip_levels;
+			d3d11_srv_desc.Texture2DArray.FirstArraySlice = 0;
+			d3d11_srv_desc.Texture2DArray.ArraySize = desc.array_layers;
+		} else {
+			d3d11_srv_desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+			d3d11_srv_desc.Texture2D.MostDetailedMip = 0;
+			d3d11_srv_desc.Texture2D.MipLevels = desc.mip_levels;
+		}
 		ID3D11ShaderResourceView* d3d11_srv = nullptr;
 		result = _device->CreateShaderResourceView(d3d11_texture2d.Get(), &d3d11_srv_desc, &d3d11_srv);
 		if (FAILED(result)) {
@@ -620,15 +680,31 @@ namespace api {
 		return TextureHandle{ .object = (uintptr_t)d3d11_srv };
 	}
 
+	bool are_texture_layer_views_supported() {
+		// PITFALL: A view of one array slice is still a Texture2DArray to HLSL, so it can't
+		// stand in for a Texture2D in the shaders that expect one.
+		return false;
+	}
+
+	TextureHandle create_texture_layer_view(TextureHandle array_texture, const TextureDesc& array_desc, unsigned int layer) {
+		return TextureHandle();
+	}
+
 	void destroy_texture(TextureHandle texture) {
 		if (!texture.object) return;
 		ID3D11ShaderResourceView* d3d11_srv = (ID3D11ShaderResourceView*)texture.object;
 		d3d11_srv->Release();
 	}
 
+	void generate_mips(TextureHandle texture) {
+		if (!texture.object) return;
+		_device_context->GenerateMips((ID3D11ShaderResourceView*)texture.object);
+	}
+
 	void update_texture(
 		TextureHandle texture,
 		unsigned int level,
+		unsigned int layer,
 		unsigned int x,
 		unsigned int y,
 		unsigned int width,
@@ -647,12 +723,16 @@ namespace api {
 		d3d11_box.right = x + width;
 		d3d11_box.bottom = y + height;
 		d3d11_box.back = 1;
+		Microsoft::WRL::ComPtr<ID3D11Texture2D> d3d11_texture2d{};
+		d3d11_resource.As(&d3d11_texture2d);
+		D3D11_TEXTURE2D_DESC d3d11_texture2d_desc{};
+		d3d11_texture2d->GetDesc(&d3d11_texture2d_desc);
 		_device_context->UpdateSubresource(
 			d3d11_resource.Get(),
-			level,
+			D3D11CalcSubresource(level, layer, d3d11_texture2d_desc.MipLevels),
 			&d3d11_box,
 			pixels,
-			width * _format_to_byte_width(pixel_format),
+			_get_row_pitch(pixel_format, width),
 			0
 		);
 	}
@@ -993,8 +1073,8 @@ namespace api {
 		_device_context->Draw(vertex_count, vertex_offset);
 	}
 
-	void draw_indexed(unsigned int index_count, unsigned int base_vertex) {
-		_device_context->DrawIndexed(index_count, 0, base_vertex);
+	void draw_indexed(unsigned int index_count, unsigned int index_offset, unsigned int base_vertex) {
+		_device_context->DrawIndexed(index_count, index_offset, base_vertex);
 	}
 
 } // namespace api
@@ -8,6 +8,11 @@
 
 #define MAX_VIEWPORTS 8u
 
+// S3TC is an extension that glad may have been generated without, but every desktop GPU supports it.
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
 // Undefine pre-DSA functions to force the use of DSA whenever possible.
 
 #undef glGenTextures
@@ -160,6 +165,13 @@ namespace api {
 		glBindProgramPipeline(_program_pipeline_object);
 		_gl_object_label(GL_PROGRAM_PIPELINE, _program_pipeline_object, "program pipeline");
 
+		// SETUP PIXEL UNPACKING
+
+		// PITFALL: By default, OpenGL expects each uploaded row to start on a 4-byte boundary.
+		// Our texture data is always tightly packed, which breaks this for e.g. R8 textures
+		// and subrectangles whose row size isn't a multiple of 4.
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
 		return true;
 	}
 
@@ -337,6 +349,11 @@ namespace api {
 		glNamedBufferSubData((GLuint)buffer.object, offset, size, data);
 	}
 
+	void update_buffer_no_overwrite(BufferHandle buffer, const void* data, unsigned int size, unsigned int offset) {
+		// SIC: glNamedBufferSubData() already leaves the rest of the buffer intact.
+		glNamedBufferSubData((GLuint)buffer.object, offset, size, data);
+	}
+
 	void bind_uniform_buffer(unsigned int binding, BufferHandle buffer) {
 		glBindBufferBase(GL_UNIFORM_BUFFER, binding, (GLuint)buffer.object);
 	}
@@ -381,38 +398,153 @@ namespace api {
 		case Format::RG8_UNORM:   return GL_RG8;
 		case Format::RGB8_UNORM:  return GL_RGB8;
 		case Format::RGBA8_UNORM: return GL_RGBA8;
+		case Format::BC3_UNORM:   return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		case Format::BC7_UNORM:   return GL_COMPRESSED_RGBA_BPTC_UNORM;
+		case Format::ETC2_RGBA8_UNORM: return GL_COMPRESSED_RGBA8_ETC2_EAC;
 		default: return 0;
 		}
 	}
 
+	bool _is_block_compressed_format(Format format) {
+		return format == Format::BC3_UNORM || format == Format::BC7_UNORM || format == Format::ETC2_RGBA8_UNORM;
+	}
+
+	bool is_texture_format_supported(Format format) {
+		const GLenum sized_format = _to_gl_sized_format(format);
+		if (!sized_format) return false;
+		// PITFALL: Desktop drivers report ETC2 as supported but decompress it on upload,
+		// so it doesn't save any memory there. Prefer the BC formats when they're available.
+		GLint supported = GL_FALSE;
+		glGetInternalformativ(GL_TEXTURE_2D, sized_format, GL_INTERNALFORMAT_SUPPORTED, 1, &supported);
+		return supported == GL_TRUE;
+	}
+
+	bool are_texture_layer_views_supported() {
+		return true; // glTextureView() is core since OpenGL 4.3
+	}
+
+	void _texture_sub_image(
+		GLuint texture_object,
+		unsigned int level,
+		unsigned int layer,
+		unsigned int x,
+		unsigned int y,
+		unsigned int width,
+		unsigned int height,
+		Format pixel_format,
+		const void* pixels
+	) {
+		GLint target = GL_TEXTURE_2D;
+		glGetTextureParameteriv(texture_object, GL_TEXTURE_TARGET, &target);
+		const bool is_array = (target == GL_TEXTURE_2D_ARRAY);
+		if (_is_block_compressed_format(pixel_format)) {
+			const GLsizei image_size = ((width + 3) / 4) * ((height + 3) / 4) * 16;
+			if (is_array) {
+				glCompressedTextureSubImage3D(
+					texture_object,
+					level,
+					x,
+					y,
+					layer,
+					width,
+					height,
+					1, // depth
+					_to_gl_sized_format(pixel_format),
+					image_size,
+					pixels
+				);
+			} else {
+				glCompressedTextureSubImage2D(
+					texture_object,
+					level,
+					x,
+					y,
+					width,
+					height,
+					_to_gl_sized_format(pixel_format),
+					image_size,
+					pixels
+				);
+			}
+		} else {
+			if (is_array) {
+				glTextureSubImage3D(
+					texture_object,
+					level,
+					x,
+					y,
+					layer,
+					width,
+					height,
+					1, // depth
+					_to_gl_base_format(pixel_format),
+					GL_UNSIGNED_BYTE,
+					pixels
+				);
+			} else {
+				glTextureSubImage2D(
+					texture_object,
+					level,
+					x,
+					y,
+					width,
+					height,
+					_to_gl_base_format(pixel_format),
+					GL_UNSIGNED_BYTE,
+					pixels
+				);
+			}
+		}
+	}
+
 	TextureHandle create_texture(const TextureDesc& desc) {
+		const GLenum target = (desc.array_layers > 1) ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D;
 		GLuint texture_object = 0;
-		glCreateTextures(GL_TEXTURE_2D, 1, &texture_object);
+		glCreateTextures(target, 1, &texture_object);
 		_gl_object_label(GL_TEXTURE, texture_object, desc.debug_name);
-		glTextureStorage2D(texture_object, 1, _to_gl_sized_format(desc.format), desc.width, desc.height);
+		if (target == GL_TEXTURE_2D_ARRAY) {
+			glTextureStorage3D(texture_object, desc.mip_levels, _to_gl_sized_format(desc.format),
+				desc.width, desc.height, desc.array_layers);
+		} else {
+			glTextureStorage2D(texture_object, desc.mip_levels, _to_gl_sized_format(desc.format), desc.width, desc.height);
+		}
 		if (desc.initial_data) {
-			glTextureSubImage2D(
-				texture_object,
-				0, // level
-				0, // xoffset
-				0, // yoffset
-				desc.width,
-				desc.height,
-				_to_gl_base_format(desc.format),
-				GL_UNSIGNED_BYTE,
-				desc.initial_data
-			);
+			_texture_sub_image(texture_object, 0, 0, 0, 0, desc.width, desc.height, desc.format, desc.initial_data);
 		}
 		return TextureHandle{ texture_object };
 	}
 
+	TextureHandle create_texture_layer_view(TextureHandle array_texture, const TextureDesc& array_desc, unsigned int layer) {
+		// PITFALL: glTextureView() requires a texture name that has been generated but never bound,
+		// which rules out glCreateTextures(). That's why we call the pre-DSA function that we otherwise undefine.
+		GLuint texture_object = 0;
+		glad_glGenTextures(1, &texture_object);
+		glTextureView(
+			texture_object,
+			GL_TEXTURE_2D,
+			(GLuint)array_texture.object,
+			_to_gl_sized_format(array_desc.format),
+			0, // min level
+			array_desc.mip_levels,
+			layer, // min layer
+			1 // layer count
+		);
+		_gl_object_label(GL_TEXTURE, texture_object, array_desc.debug_name);
+		return TextureHandle{ texture_object };
+	}
+
 	void destroy_texture(TextureHandle texture) {
 		glDeleteTextures(1, (GLuint*)&texture.object);
 	}
 
+	void generate_mips(TextureHandle texture) {
+		glGenerateTextureMipmap((GLuint)texture.object);
+	}
+
 	void update_texture(
 		TextureHandle texture,
 		unsigned int level,
+		unsigned int layer,
 		unsigned int x,
 		unsigned int y,
 		unsigned int width,
@@ -420,17 +552,7 @@ namespace api {
 		Format pixel_format,
 		const void* pixels
 	) {
-		glTextureSubImage2D(
-			(GLuint)texture.object,
-			level,
-			x,
-			y,
-			width,
-			height,
-			_to_gl_base_format(pixel_format),
-			GL_UNSIGNED_BYTE,
-			pixels
-		);
+		_texture_sub_image((GLuint)texture.object, level, layer, x, y, width, height, pixel_format, pixels);
 	}
 
 	void copy_texture(
@@ -494,8 +616,11 @@ namespace api {
 		GLuint sampler_object = 0;
 		glCreateSamplers(1, &sampler_object);
 		_gl_object_label(GL_SAMPLER, sampler_object, desc.debug_name);
+		// SIC: The minification filter also picks between mip levels, like the D3D11 filters do.
+		// Textures without mips only have one level, so they sample as if it were plain GL_NEAREST/GL_LINEAR.
 		const GLint gl_filter = _to_gl_filter(desc.filter);
-		glSamplerParameteri(sampler_object, GL_TEXTURE_MIN_FILTER, gl_filter);
+		const GLint gl_min_filter = (desc.filter == Filter::Linear) ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_NEAREST;
+		glSamplerParameteri(sampler_object, GL_TEXTURE_MIN_FILTER, gl_min_filter);
 		glSamplerParameteri(sampler_object, GL_TEXTURE_MAG_FILTER, gl_filter);
 		const GLint gl_wrap = _to_gl_wrap(desc.wrap);
 		glSamplerParameteri(sampler_object, GL_TEXTURE_WRAP_S, gl_wrap);
@@ -706,8 +831,9 @@ namespace api {
 		glDrawArrays(_primitives_to_gl_primitives(_primitives), vertex_offset, vertex_count);
 	}
 
-	void draw_indexed(unsigned int index_count, unsigned int base_vertex) {
-		glDrawElementsBaseVertex(_primitives_to_gl_primitives(_primitives), index_count, GL_UNSIGNED_INT, nullptr, base_vertex);
+	void draw_indexed(unsigned int index_count, unsigned int index_offset, unsigned int base_vertex) {
+		glDrawElementsBaseVertex(_primitives_to_gl_primitives(_primitives), index_count, GL_UNSIGNED_INT,
+			(const void*)(index_offset * sizeof(unsigned int)), base_vertex);
 	}
 
 } // namespace api
@@ -271,14 +271,19 @@ namespace api {
 	BufferHandle create_buffer(const BufferDesc& desc) { return BufferHandle(); }
 	void destroy_buffer(BufferHandle buffer) {}
 	void update_buffer(BufferHandle buffer, const void* data, unsigned int size, unsigned int offset) {}
+	void update_buffer_no_overwrite(BufferHandle buffer, const void* data, unsigned int size, unsigned int offset) {}
 	void bind_uniform_buffer(unsigned int binding, BufferHandle buffer) {}
 	void bind_uniform_buffer_range(unsigned int binding, BufferHandle buffer, unsigned int size, unsigned int offset) {}
 	void bind_vertex_buffer(VertexInputHandle sprite_vertex_input, unsigned int binding, BufferHandle buffer, unsigned int stride, unsigned int offset) {}
 	void bind_index_buffer(VertexInputHandle sprite_vertex_input, BufferHandle buffer) {}
 
+	bool is_texture_format_supported(Format format) { return false; }
+	bool are_texture_layer_views_supported() { return false; }
 	TextureHandle create_texture(const TextureDesc& desc) { return TextureHandle(); }
+	TextureHandle create_texture_layer_view(TextureHandle array_texture, const TextureDesc& array_desc, unsigned int layer) { return TextureHandle(); }
 	void destroy_texture(TextureHandle texture) {}
-	void update_texture(TextureHandle texture, unsigned int level, unsigned int x, unsigned int y,
+	void generate_mips(TextureHandle texture) {}
+	void update_texture(TextureHandle texture, unsigned int level, unsigned int layer, unsigned int x, unsigned int y,
 		unsigned int width, unsigned int height, Format pixel_format, const void* pixels) {}
 	void copy_texture(
 		TextureHandle dst_texture, unsigned int dst_level, unsigned int dst_x, unsigned int dst_y, unsigned int dst_z,
@@ -301,7 +306,7 @@ namespace api {
 	void set_scissor_test_enabled(bool enable) {}
 
 	void draw_all(Primitives primitives, unsigned int vertex_count, unsigned int vertex_offset) {}
-	void draw_indexed(Primitives primitives, unsigned int index_count) {}
+	void draw_indexed(unsigned int index_count, unsigned int index_offset, unsigned int base_vertex) {}
 
 } // namespace api
 } // namespace graphics
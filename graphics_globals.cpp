@@ -17,10 +17,13 @@ namespace graphics {
 	Handle<FragmentShader> darkness_frag;
 	Handle<VertexShader> sprite_vert;
 	Handle<FragmentShader> sprite_frag;
+	Handle<VertexShader> sprite_array_vert;
+	Handle<FragmentShader> sprite_array_frag;
 	Handle<VertexShader> grass_vert;
 	Handle<VertexShader> shape_vert;
 	Handle<FragmentShader> shape_frag;
 	Handle<FragmentShader> text_frag;
+	Handle<FragmentShader> text_sdf_frag;
 	Handle<VertexShader> ui_vert;
 	Handle<FragmentShader> ui_frag;
 	Handle<VertexShader> ui_rectangle_vert;
@@ -54,163 +57,127 @@ namespace graphics {
 
 	Handle<BlendState> default_blend_state;
 
-	void _load_and_create_shaders_and_vertex_inputs() {
-		std::vector<unsigned char> shader_code;
+	// Each shader is loaded from "assets/shaders/<file_name><extension>",
+	// where the extension depends on the graphics API and what it supports.
+	struct _ShaderFile {
+		std::string_view file_name;
+		std::string_view debug_name;
+		Handle<VertexShader>* vertex_shader = nullptr;
+		Handle<FragmentShader>* fragment_shader = nullptr;
+	};
+
+	const _ShaderFile _SHADER_FILES[] = {
+		{ "fullscreen.vert", "fullscreen vertex shader", &fullscreen_vert },
+		{ "fullscreen_flip.vert", "fullscreen flip vertex shader", &fullscreen_flip_vert },
+		{ "fullscreen.frag", "fullscreen fragment shader", nullptr, &fullscreen_frag },
+		{ "gaussian_blur_hor.frag", "gaussian blur horizontal fragment shader", nullptr, &gaussian_blur_hor_frag },
+		{ "gaussian_blur_ver.frag", "gaussian blur vertical fragment shader", nullptr, &gaussian_blur_ver_frag },
+		{ "screen_transition.frag", "screen transition fragment shader", nullptr, &screen_transition_frag },
+		{ "shockwave.frag", "shockwave fragment shader", nullptr, &shockwave_frag },
+		{ "darkness.frag", "darkness fragment shader", nullptr, &darkness_frag },
+		{ "sprite.vert", "sprite vertex shader", &sprite_vert },
+		{ "sprite.frag", "sprite fragment shader", nullptr, &sprite_frag },
+		{ "sprite_array.vert", "sprite array vertex shader", &sprite_array_vert },
+		{ "sprite_array.frag", "sprite array fragment shader", nullptr, &sprite_array_frag },
+		{ "grass.vert", "grass vertex shader", &grass_vert },
+		{ "shape.vert", "shape vertex shader", &shape_vert },
+		{ "shape.frag", "shape fragment shader", nullptr, &shape_frag },
+		{ "text.frag", "text fragment shader", nullptr, &text_frag },
+		{ "text_sdf.frag", "text sdf fragment shader", nullptr, &text_sdf_frag },
+		{ "ui.vert", "ui vertex shader", &ui_vert },
+		{ "ui.frag", "ui fragment shader", nullptr, &ui_frag },
+		{ "ui_rectangle.vert", "ui rectangle vertex shader", &ui_rectangle_vert },
+		{ "ui_rectangle.frag", "ui rectangle fragment shader", nullptr, &ui_rectangle_frag },
+		{ "player_outfit.frag", "player outfit fragment shader", nullptr, &player_outfit_frag },
+	};
+
+	bool _is_shader_code_binary() {
 #ifdef GRAPHICS_API_OPENGL
-		const bool binary = graphics::is_spirv_supported();
-		const std::string extension = binary ? ".spv" : "";
+		return graphics::is_spirv_supported();
 #endif
 #ifdef GRAPHICS_API_D3D11
-		const bool binary = true;
-		const std::string extension = binary ? ".dxbc" : ".hlsl";
+		return true;
 #endif
-		if (filesystem::read_binary_file("assets/shaders/fullscreen.vert" + extension, shader_code)) {
-			fullscreen_vert = create_vertex_shader({
-				.debug_name = "fullscreen vertex shader",
-				.code = shader_code,
-				.binary = binary
-			});
-		}
-		if (filesystem::read_binary_file("assets/shaders/fullscreen_flip.vert" + extension, shader_code)) {
-			fullscreen_flip_vert = create_vertex_shader({
-				.debug_name = "fullscreen flip vertex shader",
-				.code = shader_code,
-				.binary = binary
-			});
-		}
-		if (filesystem::read_binary_file("assets/shaders/fullscreen.frag" + extension, shader_code)) {
-			fullscreen_frag = create_fragment_shader({
-				.debug_name = "fullscreen fragment shader",
-				.code = shader_code,
-				.binary = binary
-			});
-		}
-		if (filesystem::read_binary_file("assets/shaders/gaussian_blur_hor.frag" + extension, shader_code)) {
-			gaussian_blur_hor_frag = create_fragment_shader({
-				.debug_name = "gaussian blur horizontal fragment shader",
-				.code = shader_code,
-				.binary = binary
-			});
-		}
-		if (filesystem::read_binary_file("assets/shaders/gaussian_blur_ver.frag" + extension, shader_code)) {
-			gaussian_blur_ver_frag = create_fragment_shader({
-				.debug_name = "gaussian blur vertical fragment shader",
-				.code = shader_code,
-				.binary = binary
-			});
-		}
-		if (filesystem::read_binary_file("assets/shaders/screen_transition.frag" + extension, shader_code)) {
-			screen_transition_frag = create_fragment_shader({
-				.debug_name = "screen transition fragment shader",
-				.code = shader_code,
-				.binary = binary
-			});
-		}
-		if (filesystem::read_binary_file("assets/shaders/shockwave.frag" + extension, shader_code)) {
-			shockwave_frag = create_fragment_shader({
-				.debug_name = "shockwave fragment shader",
-				.code = shader_code,
-				.binary = binary
-			});
-		}
-		if (filesystem::read_binary_file("assets/shaders/darkness.frag" + extension, shader_code)) {
-			darkness_frag = create_fragment_shader({
-				.debug_name = "darkness fragment shader",
-				.code = shader_code,
-				.binary = binary
-			});
-		}
-		if (filesystem::read_binary_file("assets/shaders/sprite.vert" + extension, shader_code)) {
-			sprite_vert = create_vertex_shader({
-				.debug_name = "sprite vertex shader",
-				.code = shader_code,
-				.binary = binary
-			});
-			sprite_vertex_input = graphics::create_vertex_input({
-				.debug_name = "sprite vertex input",
-				.attributes = { {
-					.format = Format::RG32_FLOAT,
-					.offset = offsetof(Vertex, position)
-				}, {
-					.format = Format::RGBA8_UNORM,
-					.offset = offsetof(Vertex, color),
-					.normalized = true // FIXME: normalized is not supported in d3d11
-				}, {
-					.format = Format::RG32_FLOAT,
-					.offset = offsetof(Vertex, tex_coord)
-				}, },
-				.bytecode = shader_code
-			});
-		}
-		if (filesystem::read_binary_file("assets/shaders/sprite.frag" + extension, shader_code)) {
-			sprite_frag = create_fragment_shader({
-				.debug_name = "sprite fragment shader",
-				.code = shader_code,
-				.binary = binary
-			});
-		}
-		if (filesystem::read_binary_file("assets/shaders/grass.vert" + extension, shader_code)) {
-			grass_vert = create_vertex_shader({
-				.debug_name = "grass vertex shader",
-				.code = shader_code,
-				.binary = binary
-			});
-		}
-		if (filesystem::read_binary_file("assets/shaders/shape.vert" + extension, shader_code)) {
-			shape_vert = create_vertex_shader({
-				.debug_name = "shape vertex shader",
-				.code = shader_code,
-				.binary = binary
-			});
-		}
-		if (filesystem::read_binary_file("assets/shaders/shape.frag" + extension, shader_code)) {
-			shape_frag = create_fragment_shader({
-				.debug_name = "shape fragment shader",
-				.code = shader_code,
-				.binary = binary
-			});
-		}
-		if (filesystem::read_binary_file("assets/shaders/text.frag" + extension, shader_code)) {
-			text_frag = create_fragment_shader({
-				.debug_name = "text fragment shader",
-				.code = shader_code,
-				.binary = binary
-			});
-		}
-		if (filesystem::read_binary_file("assets/shaders/ui.vert" + extension, shader_code)) {
-			ui_vert = create_vertex_shader({
-				.debug_name = "ui vertex shader",
-				.code = shader_code,
-				.binary = binary
-			});
+	}
+
+	std::string _get_shader_file_extension() {
+#ifdef GRAPHICS_API_OPENGL
+		return _is_shader_code_binary() ? ".spv" : "";
+#endif
+#ifdef GRAPHICS_API_D3D11
+		return _is_shader_code_binary() ? ".dxbc" : ".hlsl";
+#endif
+	}
+
+	// Creates the shader, or recreates it in place if it already exists.
+	bool _load_shader(const _ShaderFile& file, std::vector<unsigned char>& shader_code) {
+		const std::string path = "assets/shaders/" + std::string(file.file_name) + _get_shader_file_extension();
+		if (!filesystem::read_binary_file(path, shader_code)) return false;
+		ShaderDesc desc{
+			.debug_name = file.debug_name,
+			.code = shader_code,
+			.binary = _is_shader_code_binary()
+		};
+		if (file.vertex_shader) {
+			if (*file.vertex_shader == Handle<VertexShader>()) {
+				*file.vertex_shader = create_vertex_shader(std::move(desc));
+			} else if (!recreate_vertex_shader(*file.vertex_shader, std::move(desc))) {
+				return false;
+			}
 		}
-		if (filesystem::read_binary_file("assets/shaders/ui.frag" + extension, shader_code)) {
-			ui_frag = create_fragment_shader({
-				.debug_name = "ui fragment shader",
-				.code = shader_code,
-				.binary = binary
-			});
+		if (file.fragment_shader) {
+			if (*file.fragment_shader == Handle<FragmentShader>()) {
+				*file.fragment_shader = create_fragment_shader(std::move(desc));
+			} else if (!recreate_fragment_shader(*file.fragment_shader, std::move(desc))) {
+				return false;
+			}
 		}
-		if (filesystem::read_binary_file("assets/shaders/ui_rectangle.vert" + extension, shader_code)) {
-			ui_rectangle_vert = create_vertex_shader({
-				.debug_name = "ui rectangle vertex shader",
-				.code = shader_code,
-				.binary = binary
-			});
+		return true;
+	}
+
+	void _load_and_create_shaders_and_vertex_inputs() {
+		std::vector<unsigned char> shader_code;
+		for (const _ShaderFile& file : _SHADER_FILES) {
+			if (!_load_shader(file, shader_code)) continue;
+			if (file.vertex_shader == &sprite_vert) {
+				sprite_vertex_input = graphics::create_vertex_input({
+					.debug_name = "sprite vertex input",
+					.attributes = { {
+						.format = Format::RG32_FLOAT,
+						.offset = offsetof(Vertex, position)
+					}, {
+						.format = Format::RGBA8_UNORM,
+						.offset = offsetof(Vertex, color),
+						.normalized = true // FIXME: normalized is not supported in d3d11
+					}, {
+						.format = Format::RG32_FLOAT,
+						.offset = offsetof(Vertex, tex_coord)
+					}, {
+						.format = Format::R32_FLOAT,
+						.offset = offsetof(Vertex, tex_layer)
+					}, },
+					.bytecode = shader_code
+				});
+			}
 		}
-		if (filesystem::read_binary_file("assets/shaders/ui_rectangle.frag" + extension, shader_code)) {
-			ui_rectangle_frag = create_fragment_shader({
-				.debug_name = "ui rectangle fragment shader",
-				.code = shader_code,
-				.binary = binary
-			});
+	}
+
+	bool reload_shader_from_file(std::string_view path) {
+		const std::string file_name = filesystem::get_filename(path);
+		const std::string extension = _get_shader_file_extension();
+		std::vector<unsigned char> shader_code;
+		for (const _ShaderFile& file : _SHADER_FILES) {
+			if (file_name != std::string(file.file_name) + extension) continue;
+			// PITFALL: The sprite vertex input isn't recreated, since its layout is fixed by the Vertex struct.
+			return _load_shader(file, shader_code);
 		}
-		if (filesystem::read_binary_file("assets/shaders/player_outfit.frag" + extension, shader_code)) {
-			player_outfit_frag = create_fragment_shader({
-				.debug_name = "player outfit fragment shader",
-				.code = shader_code,
-				.binary = binary
-			});
+		return false;
+	}
+
+	void reload_shaders() {
+		std::vector<unsigned char> shader_code;
+		for (const _ShaderFile& file : _SHADER_FILES) {
+			_load_shader(file, shader_code);
 		}
 	}
 
@@ -235,7 +202,7 @@ namespace graphics {
 		});
 		ui_uniform_buffer = create_buffer({
 			.debug_name = "ui uniform buffer",
-			.size = sizeof(UiUniformBlock),
+			.size = 256 * 256, // 256-byte slot per UI draw; grows if a frame has more than 256 draws
 			.type = BufferType::UniformBuffer,
 			.dynamic = true
 		});
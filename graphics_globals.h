@@ -66,10 +66,14 @@ namespace graphics {
 	extern Handle<FragmentShader> darkness_frag;
 	extern Handle<VertexShader> sprite_vert;
 	extern Handle<FragmentShader> sprite_frag;
+	// Same as sprite_vert and sprite_frag, but sample a texture array at the layer of each vertex.
+	extern Handle<VertexShader> sprite_array_vert;
+	extern Handle<FragmentShader> sprite_array_frag;
 	extern Handle<VertexShader> grass_vert;
 	extern Handle<VertexShader> shape_vert;
 	extern Handle<FragmentShader> shape_frag;
 	extern Handle<FragmentShader> text_frag;
+	extern Handle<FragmentShader> text_sdf_frag;
 	extern Handle<VertexShader> ui_vert;
 	extern Handle<FragmentShader> ui_frag;
 	extern Handle<VertexShader> ui_rectangle_vert;
@@ -119,4 +123,7 @@ namespace graphics {
 
 	void initialize_globals();
 	void resize_final_framebuffer(unsigned int new_width, unsigned int new_height);
+	// Recreates the shader loaded from the file, if any. Existing shader handles stay valid.
+	bool reload_shader_from_file(std::string_view path);
+	void reload_shaders();
 }
\ No newline at end of file
@@ -24,6 +24,11 @@ namespace graphics {
 		RG32_FLOAT,
 		RGB32_FLOAT,
 		RGBA32_FLOAT,
+		// Block-compressed formats, which store 4x4 pixel blocks of 16 bytes each.
+		// They can only be used for textures.
+		BC3_UNORM,
+		BC7_UNORM,
+		ETC2_RGBA8_UNORM,
 	};
 
 	struct VertexInputAttribDesc {
@@ -59,7 +64,9 @@ namespace graphics {
 		unsigned int width = 0;
 		unsigned int height = 0;
 		Format format = Format::UNKNOWN;
-		const void* initial_data = nullptr;
+		unsigned int mip_levels = 1; // 0 = a full mip chain, down to 1x1
+		unsigned int array_layers = 1; // If greater than 1, the texture is a 2D texture array.
+		const void* initial_data = nullptr; // Only fills the first mip level of the first layer.
 		bool framebuffer_color = false; // If true, the texture can be used as a framebuffer color attachment.
 	};
 
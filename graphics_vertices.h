@@ -7,5 +7,6 @@ namespace graphics {
 		Vector2f position;
 		Color color;
 		Vector2f tex_coord;
+		float tex_layer = 0.f; // only read by the sprite array shaders
 	};
 }
\ No newline at end of file
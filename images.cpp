@@ -1,6 +1,15 @@
 #include "stdafx.h"
 #include "images.h"
 #include "console.h"
+#include "filesystem.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define IMAGES_SSE2
+#endif
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 #define KHRONOS_STATIC
@@ -8,45 +17,351 @@
 
 namespace images {
 
-	bool _load_image(const std::string& path, Image& image) {
+	// A list of images being decoded in parallel. Threads claim images by incrementing next_index.
+	struct _DecodeBatch {
+		std::span<const std::string> paths;
+		std::span<Image> images;
+		std::vector<std::string> errors; // one per image, empty on success
+		std::atomic<size_t> next_index = 0;
+	};
+
+	std::vector<std::thread> _decode_threads;
+	std::mutex _decode_mutex;
+	std::condition_variable _decode_batch_started;
+	std::condition_variable _decode_batch_finished;
+	_DecodeBatch* _decode_batch = nullptr; // nullptr = no batch in progress
+	uint64_t _decode_batch_id = 0; // incremented for every batch, so that threads don't join the same batch twice
+	size_t _decode_threads_busy = 0;
+	bool _decode_threads_quit = false;
+
+	// PITFALL: The decode functions are called from the decode threads,
+	// so they report errors through the error string instead of logging them.
+
+	bool _decode_image(const std::string& path, Image& image, std::string& error) {
+		filesystem::MappedFile file{};
+		if (!filesystem::map_file(path, file)) {
+			error = "Failed to open image: " + path;
+			return false;
+		}
 		int width, height, channels;
-		unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
+		unsigned char* data = stbi_load_from_memory(file.data.data(), (int)file.data.size(), &width, &height, &channels, 0);
+		filesystem::unmap_file(file);
 		if (!data) {
-			console::log_error("Failed to load image: " + path);
-			console::log_error(stbi_failure_reason());
+			// SIC: stbi_failure_reason() is thread-local if STBI_THREAD_LOCAL is supported, which it is on MSVC.
+			error = "Failed to load image: " + path + " (" + stbi_failure_reason() + ")";
 			return false;
 		}
 		image.width = width;
 		image.height = height;
 		image.channels = channels;
+		image.size = (size_t)width * height * channels;
 		image.data = data;
 		return true;
 	}
 
-	bool _load_ktx2_image(const std::string& path, Image& image) {
+	// Transcoded images are cached on disk, so that we only pay for transcoding the first time.
+	// Each cache file is named after the hash of the source file and the transcode target.
+	const std::string _TRANSCODE_CACHE_DIRECTORY = "cache/textures/";
+	const uint32_t _TRANSCODE_CACHE_VERSION = 1;
+
+	struct _TranscodeCacheHeader {
+		char magic[4] = { 'T', 'X', 'C', 'H' };
+		uint32_t version = _TRANSCODE_CACHE_VERSION;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		uint32_t compression = 0;
+		uint32_t size = 0; // of the data that follows, in bytes
+	};
+
+	Compression _transcode_target = Compression::None;
+	std::mutex _transcoder_initialization_mutex;
+	std::atomic<bool> _transcoder_initialized = false;
+
+	void set_transcode_target(Compression compression) {
+		_transcode_target = compression;
+	}
+
+	uint64_t _hash_bytes(std::span<const unsigned char> bytes) {
+		uint64_t hash = 14695981039346656037ull; // FNV-1a
+		for (unsigned char byte : bytes) {
+			hash ^= byte;
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	std::string _get_transcode_cache_path(uint64_t source_hash) {
+		std::string path = _TRANSCODE_CACHE_DIRECTORY;
+		for (int shift = 60; shift >= 0; shift -= 4) {
+			path += "0123456789abcdef"[(source_hash >> shift) & 0xf];
+		}
+		path += '.';
+		path += magic_enum::enum_name(_transcode_target);
+		return path;
+	}
+
+	ktx_transcode_fmt_e _get_ktx_transcode_format(Compression compression) {
+		switch (compression) {
+		case Compression::BC3:  return KTX_TTF_BC3_RGBA;
+		case Compression::BC7:  return KTX_TTF_BC7_RGBA;
+		case Compression::ETC2: return KTX_TTF_ETC2_RGBA;
+		default:                return KTX_TTF_RGBA32;
+		}
+	}
+
+	bool _load_cached_image(const std::string& cache_path, Image& image) {
+		filesystem::MappedFile file{};
+		if (!filesystem::map_file(cache_path, file)) return false;
+		_TranscodeCacheHeader header{};
+		if (file.data.size() >= sizeof(header)) {
+			memcpy(&header, file.data.data(), sizeof(header));
+		}
+		const _TranscodeCacheHeader expected_header{};
+		if (memcmp(header.magic, expected_header.magic, sizeof(header.magic)) ||
+			header.version != _TRANSCODE_CACHE_VERSION ||
+			header.compression != (uint32_t)_transcode_target ||
+			header.size != file.data.size() - sizeof(header)) {
+			filesystem::unmap_file(file);
+			return false;
+		}
+		// SIC: We allocate with STBI_MALLOC, so that free_image() can free the data with stbi_image_free().
+		image.data = STBI_MALLOC(header.size);
+		memcpy(image.data, file.data.data() + sizeof(header), header.size);
+		filesystem::unmap_file(file);
+		image.width = header.width;
+		image.height = header.height;
+		image.channels = 4;
+		image.compression = _transcode_target;
+		image.size = header.size;
+		return true;
+	}
+
+	void _save_cached_image(const std::string& cache_path, const Image& image) {
+		_TranscodeCacheHeader header{};
+		header.width = image.width;
+		header.height = image.height;
+		header.compression = (uint32_t)image.compression;
+		header.size = (uint32_t)image.size;
+		std::vector<unsigned char> data(sizeof(header) + image.size);
+		memcpy(data.data(), &header, sizeof(header));
+		memcpy(data.data() + sizeof(header), image.data, image.size);
+		// The cache is an optimization, so we don't care if writing it fails (e.g. in a read-only install directory).
+		filesystem::create_directories(_TRANSCODE_CACHE_DIRECTORY);
+		filesystem::write_binary_file(cache_path, data);
+	}
+
+	bool _decode_ktx2_image(const std::string& path, Image& image, std::string& error) {
+		filesystem::MappedFile file{};
+		if (!filesystem::map_file(path, file)) {
+			error = "Failed to open KTX2 texture: " + path;
+			return false;
+		}
 		ktxTexture2* ktx_texture2 = nullptr;
-		ktxResult result = ktxTexture2_CreateFromNamedFile(path.c_str(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &ktx_texture2);
+		ktxResult result = ktxTexture2_CreateFromMemory(file.data.data(), file.data.size(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &ktx_texture2);
 		if (result != KTX_SUCCESS) {
-			console::log_error("Failed to load KTX2 texture: " + path);
-			console::log_error(ktxErrorString(result));
+			filesystem::unmap_file(file);
+			error = "Failed to load KTX2 texture: " + path + " (" + ktxErrorString(result) + ")";
 			return false;
 		}
+
+		std::string cache_path; // empty if the image isn't transcoded
+		if (ktxTexture2_NeedsTranscoding(ktx_texture2)) {
+			cache_path = _get_transcode_cache_path(_hash_bytes(file.data));
+			filesystem::unmap_file(file); // The image data has been copied into the KTX texture.
+			if (_load_cached_image(cache_path, image)) {
+				ktxTexture_Destroy(ktxTexture(ktx_texture2));
+				return true;
+			}
+			// PITFALL: The first transcode initializes global transcoder tables without synchronization,
+			// so we make sure that it happens on one thread before the others are let through.
+			if (_transcoder_initialized) {
+				result = ktxTexture2_TranscodeBasis(ktx_texture2, _get_ktx_transcode_format(_transcode_target), 0);
+			} else {
+				std::lock_guard lock(_transcoder_initialization_mutex);
+				result = ktxTexture2_TranscodeBasis(ktx_texture2, _get_ktx_transcode_format(_transcode_target), 0);
+				_transcoder_initialized = true;
+			}
+			if (result != KTX_SUCCESS) {
+				ktxTexture_Destroy(ktxTexture(ktx_texture2));
+				error = "Failed to transcode KTX2 texture: " + path + " (" + ktxErrorString(result) + ")";
+				return false;
+			}
+			image.compression = _transcode_target;
+		} else {
+			filesystem::unmap_file(file); // The image data has been copied into the KTX texture.
+		}
+
+		ktx_size_t offset = 0;
+		ktxTexture_GetImageOffset(ktxTexture(ktx_texture2), 0, 0, 0, &offset);
 		image.width = ktx_texture2->baseWidth;
 		image.height = ktx_texture2->baseHeight;
-		image.channels = ktxTexture_GetElementSize(ktxTexture(ktx_texture2));
-		image.data = ktxTexture_GetData(ktxTexture(ktx_texture2));
+		image.channels = (image.compression == Compression::None) ? ktxTexture_GetElementSize(ktxTexture(ktx_texture2)) : 4;
+		image.size = ktxTexture_GetImageSize(ktxTexture(ktx_texture2), 0);
+		image.data = ktxTexture_GetData(ktxTexture(ktx_texture2)) + offset;
 		image._private = ktx_texture2; // Store the KTX texture for later cleanup
+
+		if (!cache_path.empty()) {
+			_save_cached_image(cache_path, image);
+		}
 		return true;
 	}
 
-	bool load_image(const std::string& path, Image& image) {
+	bool _decode_any_image(const std::string& path, Image& image, std::string& error) {
 		if (path.ends_with(".ktx2")) {
-			return _load_ktx2_image(path, image);
+			return _decode_ktx2_image(path, image, error);
 		} else {
-			return _load_image(path, image);
+			return _decode_image(path, image, error);
 		}
 	}
 
+	// Decodes images from the batch until there are none left to claim.
+	void _decode_images(_DecodeBatch& batch) {
+		for (size_t i = batch.next_index++; i < batch.paths.size(); i = batch.next_index++) {
+			_decode_any_image(batch.paths[i], batch.images[i], batch.errors[i]);
+		}
+	}
+
+	void _decode_thread_main() {
+		uint64_t last_batch_id = 0;
+		std::unique_lock lock(_decode_mutex);
+		while (true) {
+			_decode_batch_started.wait(lock, [&] {
+				return _decode_threads_quit || (_decode_batch && _decode_batch_id != last_batch_id);
+			});
+			if (_decode_threads_quit) return;
+			last_batch_id = _decode_batch_id;
+			_DecodeBatch& batch = *_decode_batch;
+			_decode_threads_busy++;
+			lock.unlock();
+			_decode_images(batch);
+			lock.lock();
+			if (--_decode_threads_busy == 0) {
+				_decode_batch_finished.notify_all();
+			}
+		}
+	}
+
+	void _start_decode_threads() {
+		// The calling thread decodes as well, so we leave one hardware thread for it.
+		const size_t thread_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+		_decode_threads_quit = false;
+		for (size_t i = 0; i < thread_count; ++i) {
+			_decode_threads.emplace_back(_decode_thread_main);
+		}
+	}
+
+	void shutdown() {
+		{
+			std::lock_guard lock(_decode_mutex);
+			_decode_threads_quit = true;
+		}
+		_decode_batch_started.notify_all();
+		for (std::thread& thread : _decode_threads) {
+			thread.join();
+		}
+		_decode_threads.clear();
+	}
+
+	bool load_image(const std::string& path, Image& image) {
+		std::string error;
+		if (!_decode_any_image(path, image, error)) {
+			console::log_error(error);
+			return false;
+		}
+		return true;
+	}
+
+	void load_images(std::span<const std::string> paths, std::span<Image> images) {
+		assert(paths.size() == images.size());
+		if (paths.empty()) return;
+		if (_decode_threads.empty()) {
+			_start_decode_threads();
+		}
+
+		_DecodeBatch batch{ .paths = paths, .images = images };
+		batch.errors.resize(paths.size());
+		{
+			std::lock_guard lock(_decode_mutex);
+			_decode_batch = &batch;
+			_decode_batch_id++;
+		}
+		_decode_batch_started.notify_all();
+		_decode_images(batch);
+		{
+			// PITFALL: All images have been claimed at this point, but other threads may still be
+			// decoding theirs, and threads that haven't woken up yet mustn't touch the batch afterwards.
+			std::unique_lock lock(_decode_mutex);
+			_decode_batch_finished.wait(lock, [] { return _decode_threads_busy == 0; });
+			_decode_batch = nullptr;
+		}
+
+		for (const std::string& error : batch.errors) {
+			if (!error.empty()) {
+				console::log_error(error);
+			}
+		}
+	}
+
+	// Writes one row of a mip by averaging the 2x2 blocks of pixels in two rows of the source image.
+	// Source pixels past the right edge are clamped, so that odd widths work too.
+	void _downsample_row(const uint8_t* src_row_0, const uint8_t* src_row_1, uint8_t* dest_row,
+		unsigned int src_width, unsigned int dest_width, unsigned int channels) {
+		unsigned int dest_x = 0;
+#ifdef IMAGES_SSE2
+		if (channels == 4) {
+			// Each iteration reads 4 pixels from both rows and writes 2 pixels.
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i two = _mm_set1_epi16(2);
+			for (; dest_x + 2 <= dest_width && 2 * dest_x + 4 <= src_width; dest_x += 2) {
+				const __m128i row_0 = _mm_loadu_si128((const __m128i*)(src_row_0 + 8 * dest_x));
+				const __m128i row_1 = _mm_loadu_si128((const __m128i*)(src_row_1 + 8 * dest_x));
+				// Widen to 16 bits and add the rows, so each half holds the vertical sums of two pixels.
+				const __m128i sum_lo = _mm_add_epi16(_mm_unpacklo_epi8(row_0, zero), _mm_unpacklo_epi8(row_1, zero));
+				const __m128i sum_hi = _mm_add_epi16(_mm_unpackhi_epi8(row_0, zero), _mm_unpackhi_epi8(row_1, zero));
+				// Add the horizontal neighbors, which are 4 channels (8 bytes) apart.
+				const __m128i block_lo = _mm_add_epi16(sum_lo, _mm_srli_si128(sum_lo, 8));
+				const __m128i block_hi = _mm_add_epi16(sum_hi, _mm_srli_si128(sum_hi, 8));
+				__m128i average = _mm_unpacklo_epi64(block_lo, block_hi);
+				average = _mm_srli_epi16(_mm_add_epi16(average, two), 2); // rounded
+				_mm_storel_epi64((__m128i*)(dest_row + 4 * dest_x), _mm_packus_epi16(average, zero));
+			}
+		}
+#endif
+		for (; dest_x < dest_width; ++dest_x) {
+			const unsigned int x0 = 2 * dest_x;
+			const unsigned int x1 = std::min(x0 + 1, src_width - 1);
+			for (unsigned int c = 0; c < channels; ++c) {
+				const unsigned int sum =
+					src_row_0[x0 * channels + c] + src_row_0[x1 * channels + c] +
+					src_row_1[x0 * channels + c] + src_row_1[x1 * channels + c];
+				dest_row[dest_x * channels + c] = (uint8_t)((sum + 2) / 4);
+			}
+		}
+	}
+
+	bool generate_mip(const Image& image, Image& mip) {
+		if (!image.data || image.compression != Compression::None || !image.channels) return false;
+		mip = {};
+		mip.width = std::max(image.width / 2, 1u);
+		mip.height = std::max(image.height / 2, 1u);
+		mip.channels = image.channels;
+		mip.size = (size_t)mip.width * mip.height * mip.channels;
+		// SIC: We allocate with STBI_MALLOC, so that free_image() can free the data with stbi_image_free().
+		mip.data = STBI_MALLOC(mip.size);
+		const size_t src_pitch = (size_t)image.width * image.channels;
+		const size_t dest_pitch = (size_t)mip.width * mip.channels;
+		for (unsigned int y = 0; y < mip.height; ++y) {
+			const unsigned int y0 = 2 * y;
+			const unsigned int y1 = std::min(y0 + 1, image.height - 1);
+			_downsample_row(
+				(const uint8_t*)image.data + y0 * src_pitch,
+				(const uint8_t*)image.data + y1 * src_pitch,
+				(uint8_t*)mip.data + y * dest_pitch,
+				image.width, mip.width, image.channels);
+		}
+		return true;
+	}
+
 	void free_image(Image& image) {
 		if (image._private) {
 			ktxTexture_Destroy(ktxTexture(image._private));
@@ -55,4 +370,4 @@ namespace images {
 		}
 		image = {};
 	}
-}
\ No newline at end of file
+}
@@ -2,14 +2,37 @@
 
 namespace images {
 
+	// Block-compressed formats, which store 4x4 pixel blocks of 16 bytes each.
+	enum class Compression {
+		None,
+		BC3,
+		BC7,
+		ETC2,
+	};
+
 	struct Image {
 		unsigned int width = 0;
 		unsigned int height = 0;
 		unsigned int channels = 0;
+		Compression compression = Compression::None;
+		size_t size = 0; // in bytes
 		void* data = nullptr;
 		void* _private = nullptr; // For internal use only
 	};
 
+	void shutdown(); // Stops the decode threads, if they were started.
+
+	// Sets the format that Basis Universal supercompressed KTX2 images are transcoded to.
+	// With Compression::None, they are transcoded to uncompressed RGBA8 instead.
+	// Call this before loading any images, since it's not synchronized with the decode threads.
+	void set_transcode_target(Compression compression);
+
 	bool load_image(const std::string& path, Image& image);
+	// Decodes the images on multiple threads and returns once all are done.
+	// Images that fail to load are left empty, and their errors are logged.
+	void load_images(std::span<const std::string> paths, std::span<Image> images);
 	void free_image(Image& image);
-}
\ No newline at end of file
+	// Creates the next mip level of an uncompressed image, at half its width and height
+	// (rounded down, but at least 1), by averaging each 2x2 block of pixels.
+	bool generate_mip(const Image& image, Image& mip);
+}
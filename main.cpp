@@ -12,42 +12,60 @@
 #include "ui_textbox.h"
 #include "map.h"
 #include "ecs.h"
+#include "ecs_sprite_grid.h"
 #include "console.h"
 #include "background.h"
 #include "postprocessing.h"
 #include "settings.h"
 #include "graphics.h"
 #include "graphics_globals.h"
+#include "images.h"
 #include "shapes.h"
 #include "sprites.h"
+#include "text.h"
 #include "renderdoc.h"
 #include "imgui_impl.h"
 #include "kdtree_test.h"
+#include "text_benchmark.h"
+#include "audio_benchmark.h"
+#include <chrono>
+
+#ifdef _DEBUG_GRAPHICS
+#ifdef GRAPHICS_API_OPENGL
+const std::string_view SHADER_SOURCE_DIRECTORY = "../shaders/glsl";
+#endif
+#ifdef GRAPHICS_API_D3D11
+const std::string_view SHADER_SOURCE_DIRECTORY = "../shaders/dxbc";
+#endif
+#endif
 
 int main(int argc, char* argv[]) {
+    const auto startup_begin = std::chrono::steady_clock::now();
     if (steam::restart_app_if_necessary()) {
         return EXIT_FAILURE;
     }
     steam::initialize(); // Fails silently if Steam is not running.
-    filesystem::initialize();
-	networking::initialize();
-#ifdef _DEBUG_RENDERDOC
-    renderdoc::initialize();
-#endif
-    window::initialize();
 #ifdef _DEBUG_GRAPHICS
     // HACK: We should be using a post-build event to copy the shaders,
     // but then it doesn't run when only debugging and not recompiling,
     // which is annoying when you've changed a shader but not the code,
-    // because then the new shader doesn't get copied.
-    platform::system("del /q assets\\shaders\\*");
-#ifdef GRAPHICS_API_OPENGL
-    platform::system("copy /Y ..\\shaders\\glsl\\* assets\\shaders");
-#endif
-#ifdef GRAPHICS_API_D3D11
-	platform::system("copy /Y ..\\shaders\\dxbc\\* assets\\shaders");
+    // because then the new shader doesn't get copied. We copy them before
+    // initializing the filesystem, so that new shaders get indexed and watched.
+    filesystem::copy_newer_files(SHADER_SOURCE_DIRECTORY, "assets/shaders");
 #endif
+    filesystem::initialize();
+    // Read the Tiled files on the I/O thread while the window, graphics and audio are initializing.
+    for (const filesystem::File& file : filesystem::get_all_files_in_directory("assets/tiled")) {
+        if (file.format != filesystem::FileFormat::TiledMap &&
+            file.format != filesystem::FileFormat::TiledTileset &&
+            file.format != filesystem::FileFormat::TiledTemplate) continue;
+        filesystem::prefetch_file(file.path);
+    }
+	networking::initialize();
+#ifdef _DEBUG_RENDERDOC
+    renderdoc::initialize();
 #endif
+    window::initialize();
     graphics::initialize();
     graphics::initialize_globals();
 #ifdef _DEBUG_IMGUI
@@ -79,8 +97,16 @@ int main(int argc, char* argv[]) {
 
     window::set_visible(true);
 
+    const float startup_milliseconds = std::chrono::duration<float, std::milli>(
+        std::chrono::steady_clock::now() - startup_begin).count();
+
     // PREPARE FOR GAME LOOP
 
+#ifdef _DEBUG
+    filesystem::set_watching_enabled(true); // For hot reloading
+    const std::string shaders_directory_path = filesystem::get_normalized_path("assets/shaders");
+#endif
+
 #ifdef _DEBUG
     console::execute(argc, argv);
 #else
@@ -90,6 +116,8 @@ int main(int argc, char* argv[]) {
     bool debug_stats = false;
     bool debug_textboxes = false;
     bool debug_textures = false;
+    bool debug_text_benchmark = false;
+    bool debug_audio_benchmark = false;
 
     // GAME LOOP
 
@@ -143,6 +171,15 @@ int main(int argc, char* argv[]) {
                         map::debug = !map::debug;
                     } else if (ev.key.code == window::Key::F8) {
                         debug_textures = !debug_textures;
+                    } else if (ev.key.code == window::Key::F9) {
+                        debug_text_benchmark = !debug_text_benchmark;
+                    } else if (ev.key.code == window::Key::F10) {
+                        debug_audio_benchmark = !debug_audio_benchmark;
+                        if (!debug_audio_benchmark) {
+                            audio_benchmark::disable();
+                        }
+                    } else if (ev.key.code == window::Key::F11) {
+                        ui::debug_clay = !ui::debug_clay;
                     }
 #endif // _DEBUG
                 }
@@ -185,6 +222,35 @@ int main(int argc, char* argv[]) {
 
         // UPDATE
 
+        filesystem::update();
+#ifdef _DEBUG
+        // HOT RELOAD
+        {
+#ifdef _DEBUG_GRAPHICS
+            // Pick up shaders recompiled while the game is running.
+            static float shader_copy_timer = 0.f;
+            shader_copy_timer += app_delta_time;
+            if (shader_copy_timer >= 1.f) {
+                shader_copy_timer = 0.f;
+                filesystem::copy_newer_files(SHADER_SOURCE_DIRECTORY, "assets/shaders");
+            }
+#endif
+            for (const filesystem::File& file : filesystem::get_changed_files()) {
+                bool reloaded = false;
+                if (file.format == filesystem::FileFormat::PngImage ||
+                    file.format == filesystem::FileFormat::KhronosTexture) {
+                    reloaded = graphics::reload_texture(file.path);
+                } else if (file.format == filesystem::FileFormat::TiledMap) {
+                    reloaded = map::reload_map_from_file(file.path);
+                } else if (filesystem::get_parent_path(file.path) == shaders_directory_path) {
+                    reloaded = graphics::reload_shader_from_file(file.path);
+                }
+                if (reloaded) {
+                    console::log("Reloaded " + file.path);
+                }
+            }
+        }
+#endif
         audio::update();
         console::update(app_delta_time);
         background::update(app_delta_time);
@@ -306,6 +372,26 @@ int main(int argc, char* argv[]) {
         kdtree_test::add_debug_shapes_to_render_queue();
 #endif
 
+        // TEXT BENCHMARK
+
+        if (debug_text_benchmark) {
+            text_benchmark::show_imgui_window();
+            text_benchmark::render(camera_min + Vector2f(4.f, 12.f));
+        }
+
+        // AUDIO BENCHMARK
+
+        if (debug_audio_benchmark) {
+            audio_benchmark::show_imgui_window();
+            audio_benchmark::update();
+        }
+#endif
+
+		// RENDER TEXT TO FINAL FRAMEBUFFER
+
+        text::draw_all();
+
+#ifdef _DEBUG
 		// RENDER DEBUG SHAPES TO FINAL FRAMEBUFFER
 
         shapes::draw_all("shapes::draw_all() [ECS debug]", camera_min, camera_max);
@@ -360,9 +446,28 @@ int main(int argc, char* argv[]) {
             ImGui::PlotLines("##dt", dt_buffer, 256, buffer_offset, overlay_text, 0.f, 0.01f, ImVec2(0, 80));
             sprintf(overlay_text, "%.f FPS", smoothed_fps);
             ImGui::PlotLines("##fps", fps_buffer, 256, buffer_offset, overlay_text, 0.f, 600.f, ImVec2(0, 80));
+            ImGui::Value("Startup Time (ms)", startup_milliseconds);
             ImGui::Value("Sprites Drawn", sprites::get_sprites_drawn());
             ImGui::Value("Batches Drawn", sprites::get_batches_drawn());
             ImGui::Value("Largest Batch", sprites::get_largest_batch_sprite_count());
+            ImGui::Value("Grid Cells Visited", ecs::get_sprite_grid_cells_visited());
+            ImGui::Value("Grid Objects Visited", ecs::get_sprite_grid_objects_visited());
+            {
+                // Buffer creations are counted over one-second windows, since most frames have none.
+                static float buffer_creations_timer = 0.f;
+                static unsigned int buffers_created_at_window_start = 0;
+                static unsigned int buffer_creations_per_second = 0;
+                buffer_creations_timer += app_delta_time;
+                if (buffer_creations_timer >= 1.f) {
+                    buffer_creations_per_second = graphics::get_buffers_created() - buffers_created_at_window_start;
+                    buffers_created_at_window_start = graphics::get_buffers_created();
+                    buffer_creations_timer = 0.f;
+                }
+                ImGui::Value("Buffers Created/s", buffer_creations_per_second);
+            }
+            ImGui::Value("Audio Events Spawned", audio::get_events_spawned());
+            ImGui::Value("Audio Events Culled", audio::get_events_culled());
+            ImGui::Value("Audio Events Stolen", audio::get_events_stolen());
             ImGui::End();
         }
         if (debug_textboxes) {
@@ -402,8 +507,10 @@ int main(int argc, char* argv[]) {
     imgui_impl::shutdown();
 #endif
     graphics::shutdown();
+    images::shutdown();
     window::shutdown();
 	networking::shutdown();
+    filesystem::shutdown();
     steam::shutdown();
 
     return EXIT_SUCCESS;
@@ -5,6 +5,7 @@
 #include "tiled.h"
 #include "tiled_types.h"
 #include "filesystem.h"
+#include "graphics.h"
 #include "console.h"
 #include "audio.h"
 #include "ui_textbox.h"
@@ -74,6 +75,19 @@ namespace map {
 		}
 	}
 
+	bool reload_map_from_file(const std::string& path) {
+		// PITFALL: A hot-reloaded file may still be in the middle of being written,
+		// so we log errors instead of breaking into the debugger like at startup.
+		_tiled_context.debug_message_callback = [](std::string_view message) { console::log_error(message); };
+		const unsigned int map_id = tiled::reload_map_from_file(_tiled_context, path);
+		_tiled_context.debug_message_callback = _tiled_debug_message_callback;
+		if (map_id == UINT_MAX) return false;
+		if (_tiled_context.maps[map_id].path == _current_map_path) {
+			reset(0.f); // Re-open the map to recreate its tilegrid and entities.
+		}
+		return true;
+	}
+
 	const tiled::Map* _find_map_by_path(std::string_view path) {
 		if (path.empty()) return nullptr;
 		for (const tiled::Map& map : _tiled_context.maps) {
@@ -174,6 +188,17 @@ namespace map {
 		}
 		_next_free_layer_index = (unsigned int)next_map->layers.size();
 
+		// Decode the tileset images in parallel before the tilegrid and entities load them one by one.
+		// Tileset images of the same size go into one texture array, so that sprites from them batch together.
+		std::vector<std::string> tileset_image_paths;
+		for (const tiled::TilesetLink& link : next_map->tilesets) {
+			const tiled::Tileset& tileset = _tiled_context.tilesets[link.tileset_id];
+			if (!tileset.image_path.empty()) {
+				tileset_image_paths.push_back(tileset.image_path);
+			}
+		}
+		graphics::load_texture_arrays(tileset_image_paths);
+
 		create_tilegrid(*next_map);
 		create_entities(*next_map);
 		patch_entities(_map_path_to_patch[_current_map_path]);
@@ -23,6 +23,8 @@ namespace map {
 
 	void initialize();
 	void update(float dt);
+	// Parses the map file again, and re-opens the map if it's the current one.
+	bool reload_map_from_file(const std::string& path);
 
 	bool transition(const MapTransitionOptions& options);
 	bool is_open();
@@ -16,6 +16,7 @@
 #include "ecs_damage.h"
 #include "ecs_interactions.h"
 #include "ecs_sprites.h"
+#include "ecs_sprite_grid.h"
 #include "ecs_uniform_block.h"
 #include "ecs_animations.h"
 #include "ecs_player.h"
@@ -520,6 +521,9 @@ namespace map {
 						sprite.flags |= sprites::SPRITE_FLIP_DIAGONALLY;
 					}
 
+					// Tiles never move, so we insert them into the sprite grid once and for all.
+					ecs::update_sprite_in_grid(entity, sprite);
+
 					// EMPLACE ANIMATION
 
 					// The majority of tiles are not animated and don't change during gameplay,
@@ -0,0 +1,13 @@
+#version 460
+
+uniform sampler2DArray tex;
+
+layout(location = 0) in vec4 color;
+layout(location = 1) in vec2 tex_coord;
+layout(location = 2) in float tex_layer;
+
+layout(location = 0) out vec4 frag_color;
+
+void main() {
+	frag_color = color * texture(tex, vec3(tex_coord, tex_layer));
+}
\ No newline at end of file
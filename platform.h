@@ -7,6 +7,9 @@ namespace platform {
 	bool is_debugger_present();
 	void debug_break();
 	void output_debug_string(const char* string);
+	// Maps the file into memory read-only. Returns nullptr on failure or if the file is empty.
+	const void* map_file(const char* path, size_t& size);
+	void unmap_file(const void* data);
 }
 
 #ifdef _DEBUG
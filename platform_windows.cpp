@@ -35,6 +35,32 @@ namespace platform {
 	void output_debug_string(const char* string) {
 		OutputDebugStringA(string);
 	}
+
+	const void* map_file(const char* path, size_t& size) {
+		size = 0;
+		HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (file == INVALID_HANDLE_VALUE) return nullptr;
+		LARGE_INTEGER file_size{};
+		if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+			CloseHandle(file); // SIC: Empty files can't be mapped.
+			return nullptr;
+		}
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (!mapping) return nullptr;
+		const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping); // The view keeps the mapping alive.
+		if (!data) return nullptr;
+		size = (size_t)file_size.QuadPart;
+		return data;
+	}
+
+	void unmap_file(const void* data) {
+		if (data) {
+			UnmapViewOfFile(data);
+		}
+	}
 }
 
 #endif // PLATFORM_WINDOWS
\ No newline at end of file
@@ -346,6 +346,18 @@ namespace player {
 
 		const std::string base_dir = "assets/textures/character/";
 
+		// Decode all textures in parallel up front, so that the loads below hit the texture cache.
+		std::vector<std::string> texture_paths = {
+			base_dir + "palettes/mana seed skin ramps.png",
+			base_dir + "palettes/mana seed hair ramps.png",
+			base_dir + "palettes/mana seed 3-color ramps.png",
+			base_dir + "palettes/mana seed 4-color ramps.png",
+		};
+		for (const Layer& layer : layers) {
+			texture_paths.push_back(base_dir + layer.texture_path);
+		}
+		graphics::load_textures(texture_paths);
+
 		for (const Layer& layer : layers) {
 			const Handle<graphics::Texture> texture = graphics::load_texture(base_dir + layer.texture_path);
 			if (texture == Handle<graphics::Texture>()) continue;
@@ -0,0 +1,148 @@
+#pragma once
+
+// A fixed-capacity FIFO queue stored in a circular array. Pushing to a full
+// ring buffer overwrites the front element, so it never allocates.
+template <typename T, size_t Capacity>
+class RingBuffer {
+public:
+	static constexpr size_t capacity() { return Capacity; }
+
+	size_t size() const { return _size; }
+
+	bool empty() const { return _size == 0; }
+
+	bool full() const { return _size == Capacity; }
+
+	void clear();
+
+	// Index 0 is the front (oldest) element.
+	T& operator[](size_t index) { return _data[(_begin + index) % Capacity]; }
+	const T& operator[](size_t index) const { return _data[(_begin + index) % Capacity]; }
+
+	T& front() { return (*this)[0]; }
+	T& back() { return (*this)[_size - 1]; }
+
+	void push_back(const T& value);
+
+	void pop_front();
+
+private:
+	std::array<T, Capacity> _data{};
+	size_t _begin = 0;
+	size_t _size = 0;
+};
+
+template<typename T, size_t Capacity>
+inline void RingBuffer<T, Capacity>::clear() {
+	_begin = 0;
+	_size = 0;
+}
+
+template<typename T, size_t Capacity>
+inline void RingBuffer<T, Capacity>::push_back(const T& value) {
+	if (full()) {
+		pop_front();
+	}
+	_data[(_begin + _size) % Capacity] = value;
+	_size++;
+}
+
+template<typename T, size_t Capacity>
+inline void RingBuffer<T, Capacity>::pop_front() {
+	if (empty()) return;
+	_begin = (_begin + 1) % Capacity;
+	_size--;
+}
+
+// A fixed-capacity FIFO queue of strings, each with some data attached. The strings are stored
+// null-terminated in a circular character arena. Pushing evicts the oldest strings to make room,
+// so it never allocates.
+template <typename T, size_t MaxStrings, size_t ArenaSize>
+class StringRingBuffer {
+public:
+	size_t size() const { return _entries.size(); }
+
+	bool empty() const { return _entries.empty(); }
+
+	void clear();
+
+	// Index 0 is the front (oldest) string.
+	const char* c_str(size_t index) const { return &_arena[_entries[index].offset]; }
+	std::string_view string(size_t index) const { return { c_str(index), _entries[index].size }; }
+	T& data(size_t index) { return _entries[index].data; }
+	const T& data(size_t index) const { return _entries[index].data; }
+
+	// Strings that don't fit in the arena are truncated.
+	void push_back(std::string_view str, const T& data = {});
+
+	void pop_front();
+
+	// Returns true if pushing a string of the given size would evict other strings.
+	bool would_evict(size_t str_size) const;
+
+private:
+	struct Entry {
+		uint32_t offset = 0;
+		uint32_t size = 0;
+		T data{};
+	};
+
+	RingBuffer<Entry, MaxStrings> _entries;
+	std::array<char, ArenaSize> _arena{};
+	size_t _write_offset = 0;
+
+	// Returns the offset at which a string of the given size would be written.
+	size_t _get_write_offset(size_t str_size) const;
+	bool _is_front_in_the_way(size_t offset, size_t str_size) const;
+};
+
+template<typename T, size_t MaxStrings, size_t ArenaSize>
+inline void StringRingBuffer<T, MaxStrings, ArenaSize>::clear() {
+	_entries.clear();
+	_write_offset = 0;
+}
+
+template<typename T, size_t MaxStrings, size_t ArenaSize>
+inline size_t StringRingBuffer<T, MaxStrings, ArenaSize>::_get_write_offset(size_t str_size) const {
+	// PITFALL: Strings are never split across the end of the arena, so we wrap around early if needed.
+	return (_write_offset + str_size + 1 > ArenaSize) ? 0 : _write_offset;
+}
+
+template<typename T, size_t MaxStrings, size_t ArenaSize>
+inline bool StringRingBuffer<T, MaxStrings, ArenaSize>::_is_front_in_the_way(size_t offset, size_t str_size) const {
+	if (_entries.empty()) return false;
+	const Entry& front = _entries[0];
+	// When wrapping around, the strings between the write offset and the end of the arena
+	// are older than all other strings, so they have to go before we reach them again.
+	if (offset < _write_offset && front.offset >= _write_offset) return true;
+	return offset < front.offset + front.size + 1 && front.offset < offset + str_size + 1;
+}
+
+template<typename T, size_t MaxStrings, size_t ArenaSize>
+inline void StringRingBuffer<T, MaxStrings, ArenaSize>::push_back(std::string_view str, const T& data) {
+	str = str.substr(0, ArenaSize - 1);
+	const size_t offset = _get_write_offset(str.size());
+	// The strings are laid out in the arena in the order they were pushed, so the
+	// ones in the way of the new string are always the oldest ones.
+	while (_is_front_in_the_way(offset, str.size()) || _entries.full()) {
+		_entries.pop_front();
+	}
+	memcpy(&_arena[offset], str.data(), str.size());
+	_arena[offset + str.size()] = '\0';
+	_entries.push_back(Entry{ (uint32_t)offset, (uint32_t)str.size(), data });
+	_write_offset = offset + str.size() + 1;
+}
+
+template<typename T, size_t MaxStrings, size_t ArenaSize>
+inline void StringRingBuffer<T, MaxStrings, ArenaSize>::pop_front() {
+	_entries.pop_front();
+	if (_entries.empty()) {
+		_write_offset = 0;
+	}
+}
+
+template<typename T, size_t MaxStrings, size_t ArenaSize>
+inline bool StringRingBuffer<T, MaxStrings, ArenaSize>::would_evict(size_t str_size) const {
+	str_size = std::min(str_size, ArenaSize - 1);
+	return _entries.full() || _is_front_in_the_way(_get_write_offset(str_size), str_size);
+}
@@ -0,0 +1,21 @@
+#version 460
+
+uniform sampler2D tex;
+
+layout(location = 0) in vec4 color;
+layout(location = 1) in vec2 tex_coord;
+
+layout(location = 0) out vec4 frag_color;
+
+// Must match _SDF_ONEDGE_VALUE in fonts.cpp.
+const float ONEDGE_VALUE = 128.0 / 255.0;
+
+void main()
+{
+	float distance = texture(tex, tex_coord).r;
+	// Antialias over one screen pixel, whatever size the glyph is drawn at.
+	float width = fwidth(distance);
+	float alpha = smoothstep(ONEDGE_VALUE - width, ONEDGE_VALUE + width, distance);
+	frag_color.rgb = color.rgb;
+	frag_color.a = color.a * alpha;
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+Texture2DArray<float4> tex : register(t0);
+SamplerState _tex_sampler : register(s0);
+
+static float4 frag_color;
+static float4 color;
+static float2 tex_coord;
+static float tex_layer;
+
+struct SPIRV_Cross_Input
+{
+    float4 color : TEXCOORD0;
+    float2 tex_coord : TEXCOORD1;
+    float tex_layer : TEXCOORD2;
+};
+
+struct SPIRV_Cross_Output
+{
+    float4 frag_color : SV_Target0;
+};
+
+void frag_main()
+{
+    frag_color = color * tex.Sample(_tex_sampler, float3(tex_coord, tex_layer));
+}
+
+SPIRV_Cross_Output main(SPIRV_Cross_Input stage_input)
+{
+    color = stage_input.color;
+    tex_coord = stage_input.tex_coord;
+    tex_layer = stage_input.tex_layer;
+    frag_main();
+    SPIRV_Cross_Output stage_output;
+    stage_output.frag_color = frag_color;
+    return stage_output;
+}
@@ -0,0 +1,58 @@
+cbuffer FrameUniformBlock : register(b0)
+{
+    float _17_app_time : packoffset(c0);
+    float _17_game_time : packoffset(c0.y);
+    float _17_window_framebuffer_width : packoffset(c0.z);
+    float _17_window_framebuffer_height : packoffset(c0.w);
+    row_major float4x4 _17_view_proj_matrix : packoffset(c1);
+};
+
+
+static float4 gl_Position;
+static float2 vertex_position;
+static float4 color;
+static float4 vertex_color;
+static float2 tex_coord;
+static float2 vertex_tex_coord;
+static float tex_layer;
+static float vertex_tex_layer;
+
+struct SPIRV_Cross_Input
+{
+    float2 vertex_position : TEXCOORD0;
+    float4 vertex_color : TEXCOORD1;
+    float2 vertex_tex_coord : TEXCOORD2;
+    float vertex_tex_layer : TEXCOORD3;
+};
+
+struct SPIRV_Cross_Output
+{
+    float4 color : TEXCOORD0;
+    float2 tex_coord : TEXCOORD1;
+    float tex_layer : TEXCOORD2;
+    float4 gl_Position : SV_Position;
+};
+
+void vert_main()
+{
+    gl_Position = mul(float4(vertex_position, 0.0f, 1.0f), _17_view_proj_matrix);
+    color = vertex_color;
+    tex_coord = vertex_tex_coord;
+    tex_layer = vertex_tex_layer;
+    gl_Position.y = -gl_Position.y;
+}
+
+SPIRV_Cross_Output main(SPIRV_Cross_Input stage_input)
+{
+    vertex_position = stage_input.vertex_position;
+    vertex_color = stage_input.vertex_color;
+    vertex_tex_coord = stage_input.vertex_tex_coord;
+    vertex_tex_layer = stage_input.vertex_tex_layer;
+    vert_main();
+    SPIRV_Cross_Output stage_output;
+    stage_output.gl_Position = gl_Position;
+    stage_output.color = color;
+    stage_output.tex_coord = tex_coord;
+    stage_output.tex_layer = tex_layer;
+    return stage_output;
+}
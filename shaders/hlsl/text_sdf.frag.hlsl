@@ -0,0 +1,40 @@
+static const float ONEDGE_VALUE = 0.501960813999176025390625f;
+
+Texture2D<float4> tex : register(t0);
+SamplerState _tex_sampler : register(s0);
+
+static float2 tex_coord;
+static float4 frag_color;
+static float4 color;
+
+struct SPIRV_Cross_Input
+{
+    float4 color : TEXCOORD0;
+    float2 tex_coord : TEXCOORD1;
+};
+
+struct SPIRV_Cross_Output
+{
+    float4 frag_color : SV_Target0;
+};
+
+void frag_main()
+{
+    float _distance = tex.Sample(_tex_sampler, tex_coord).x;
+    float width = fwidth(_distance);
+    float alpha = smoothstep(ONEDGE_VALUE - width, ONEDGE_VALUE + width, _distance);
+    frag_color.x = color.xyz.x;
+    frag_color.y = color.xyz.y;
+    frag_color.z = color.xyz.z;
+    frag_color.w = color.w * alpha;
+}
+
+SPIRV_Cross_Output main(SPIRV_Cross_Input stage_input)
+{
+    tex_coord = stage_input.tex_coord;
+    color = stage_input.color;
+    frag_main();
+    SPIRV_Cross_Output stage_output;
+    stage_output.frag_color = frag_color;
+    return stage_output;
+}
@@ -112,32 +112,49 @@ namespace sprites {
 				std::swap(tex_bl, tex_tr);
 			}
 
+			// Sprites drawn with the default sprite shaders from a layer of a texture array are drawn with the
+			// array and the sprite array shaders instead, so that they batch with sprites from the other layers.
+			Handle<graphics::VertexShader> vertex_shader = sprite.vertex_shader;
+			Handle<graphics::FragmentShader> fragment_shader = sprite.fragment_shader;
+			Handle<graphics::Texture> texture = sprite.texture;
+			unsigned int layer = 0;
+			if (vertex_shader == graphics::sprite_vert &&
+				fragment_shader == graphics::sprite_frag &&
+				graphics::sprite_array_vert != Handle<graphics::VertexShader>() &&
+				graphics::sprite_array_frag != Handle<graphics::FragmentShader>() &&
+				graphics::get_texture_array_layer(sprite.texture, texture, layer)
+			) {
+				vertex_shader = graphics::sprite_array_vert;
+				fragment_shader = graphics::sprite_array_frag;
+			}
+			const float tex_layer = (float)layer;
+
 			if (_batches.empty()) {
 				Batch& first_batch = _batches.emplace_back();
-				first_batch.vertex_shader = sprite.vertex_shader;
-				first_batch.fragment_shader = sprite.fragment_shader;
-				first_batch.texture = sprite.texture;
+				first_batch.vertex_shader = vertex_shader;
+				first_batch.fragment_shader = fragment_shader;
+				first_batch.texture = texture;
 				first_batch.uniform_buffer = sprite.uniform_buffer;
 				first_batch.uniform_buffer_size = sprite.uniform_buffer_size;
 				first_batch.uniform_buffer_offset = sprite.uniform_buffer_offset;
 			} else {
 				Batch& current_batch = _batches.back();
-				if (sprite.vertex_shader == current_batch.vertex_shader &&
-					sprite.fragment_shader == current_batch.fragment_shader &&
-					sprite.texture == current_batch.texture &&
+				if (vertex_shader == current_batch.vertex_shader &&
+					fragment_shader == current_batch.fragment_shader &&
+					texture == current_batch.texture &&
 					sprite.uniform_buffer == current_batch.uniform_buffer &&
 					sprite.uniform_buffer_size == current_batch.uniform_buffer_size &&
 					sprite.uniform_buffer_offset == current_batch.uniform_buffer_offset
 				) {
 					// Add degenerate triangles to separate the sprites
 					graphics::temp_vertices.emplace_back(graphics::temp_vertices.back()); // D
-					graphics::temp_vertices.emplace_back(tl, sprite.color, tex_tl); // E
+					graphics::temp_vertices.emplace_back(tl, sprite.color, tex_tl, tex_layer); // E
 					current_batch.vertex_count += 2;
 				} else {
 					Batch& new_batch = _batches.emplace_back();
-					new_batch.vertex_shader = sprite.vertex_shader;
-					new_batch.fragment_shader = sprite.fragment_shader;
-					new_batch.texture = sprite.texture;
+					new_batch.vertex_shader = vertex_shader;
+					new_batch.fragment_shader = fragment_shader;
+					new_batch.texture = texture;
 					new_batch.uniform_buffer = sprite.uniform_buffer;
 					new_batch.uniform_buffer_size = sprite.uniform_buffer_size;
 					new_batch.uniform_buffer_offset = sprite.uniform_buffer_offset;
@@ -146,10 +163,10 @@ namespace sprites {
 			}
 
 			// Add the vertices of the new sprite to the batch
-			graphics::temp_vertices.emplace_back(tl, sprite.color, tex_tl);
-			graphics::temp_vertices.emplace_back(tr, sprite.color, tex_tr);
-			graphics::temp_vertices.emplace_back(bl, sprite.color, tex_bl);
-			graphics::temp_vertices.emplace_back(br, sprite.color, tex_br);
+			graphics::temp_vertices.emplace_back(tl, sprite.color, tex_tl, tex_layer);
+			graphics::temp_vertices.emplace_back(tr, sprite.color, tex_tr, tex_layer);
+			graphics::temp_vertices.emplace_back(bl, sprite.color, tex_bl, tex_layer);
+			graphics::temp_vertices.emplace_back(br, sprite.color, tex_br, tex_layer);
 
 			// Update statistics
 			_batches.back().sprite_count += 1;
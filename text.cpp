@@ -1,4 +1,5 @@
 #include "stdafx.h"
+#include <bit>
 #include "text.h"
 #include "fonts.h"
 #include "graphics.h"
@@ -6,8 +7,58 @@
 #include "graphics_vertices.h"
 
 namespace text {
-    void render(const Text& text) {
-        if (text.unicode_string.empty()) return;
+    // Layouts that haven't been used for this many frames are evicted from the cache.
+    constexpr uint64_t _LAYOUT_CACHE_MAX_AGE = 120;
+
+    // A laid out string, as positioned quads in pixel coordinates relative to the text origin.
+    // Scale and position are applied when the layout is used, so they aren't part of the key.
+    struct Layout {
+        Handle<fonts::Font> font;
+        std::u32string unicode_string;
+        float pixel_height = 0.f;
+        float letter_spacing_factor = 0.f;
+        float line_spacing_factor = 0.f;
+        std::vector<graphics::Vertex> vertices;
+        uint64_t last_used_frame = 0;
+    };
+
+    // All text rendered during a frame using the same font (and hence atlas) is merged into one batch.
+    struct Batch {
+        Handle<fonts::Font> font;
+        std::vector<graphics::Vertex> vertices;
+    };
+
+    std::unordered_map<uint64_t, Layout> _layout_cache;
+    std::vector<Batch> _batches;
+    uint64_t _frame = 0;
+
+    uint64_t _hash_layout_key(const Text& text) {
+        // FNV-1a
+        uint64_t hash = 14695981039346656037ull;
+        const auto combine = [&hash](uint32_t value) {
+            for (int i = 0; i < 4; ++i) {
+                hash ^= (value >> (i * 8)) & 0xFF;
+                hash *= 1099511628211ull;
+            }
+        };
+        combine(text.font.index);
+        combine(text.font.generation);
+        combine(std::bit_cast<uint32_t>(text.pixel_height));
+        combine(std::bit_cast<uint32_t>(text.letter_spacing_factor));
+        combine(std::bit_cast<uint32_t>(text.line_spacing_factor));
+        for (char32_t codepoint : text.unicode_string) {
+            combine((uint32_t)codepoint);
+        }
+        return hash;
+    }
+
+    void _create_layout(const Text& text, Layout& layout) {
+        layout.font = text.font;
+        layout.unicode_string = text.unicode_string;
+        layout.pixel_height = text.pixel_height;
+        layout.letter_spacing_factor = text.letter_spacing_factor;
+        layout.line_spacing_factor = text.line_spacing_factor;
+        layout.vertices.clear();
 
         float whitespace_width = (float)fonts::get_glyph(text.font, U' ').advance_width;
         const float letter_spacing = whitespace_width * (text.letter_spacing_factor - 1.f);
@@ -15,7 +66,7 @@ namespace text {
         const float line_spacing = fonts::get_line_spacing(text.font) * text.line_spacing_factor;
         Vector2f current_point; // In unscaled coordinates
 
-        std::vector<graphics::Vertex> vertices;
+        std::vector<graphics::Vertex>& vertices = layout.vertices;
 
         char32_t previous_codepoint = 0;
         for (char32_t codepoint : text.unicode_string) {
@@ -58,16 +109,90 @@ namespace text {
         for (graphics::Vertex& vertex : vertices) {
             vertex.position.y = -vertex.position.y; // Flip y-axis
             vertex.position *= scale_for_pixel_height;
+        }
+    }
+
+    const Layout& _get_or_create_layout(const Text& text) {
+        auto [it, inserted] = _layout_cache.try_emplace(_hash_layout_key(text));
+        Layout& layout = it->second;
+        // PITFALL: On a hash collision, we simply overwrite the old layout.
+        // SIC: Whitespace-only strings have no vertices, so we can't use that to detect new layouts.
+        if (inserted ||
+            layout.font != text.font ||
+            layout.pixel_height != text.pixel_height ||
+            layout.letter_spacing_factor != text.letter_spacing_factor ||
+            layout.line_spacing_factor != text.line_spacing_factor ||
+            layout.unicode_string != text.unicode_string
+        ) {
+            _create_layout(text, layout);
+        }
+        layout.last_used_frame = _frame;
+        return layout;
+    }
+
+    void render(const Text& text) {
+        if (text.unicode_string.empty()) return;
+
+        const Layout& layout = _get_or_create_layout(text);
+        if (layout.vertices.empty()) return;
+
+        Batch* batch = nullptr;
+        for (Batch& other_batch : _batches) {
+            if (other_batch.font == text.font) {
+                batch = &other_batch;
+                break;
+            }
+        }
+        if (!batch) {
+            batch = &_batches.emplace_back();
+            batch->font = text.font;
+        }
+
+        for (graphics::Vertex vertex : layout.vertices) {
             vertex.position *= text.scale;
             vertex.position += text.position;
+            batch->vertices.push_back(vertex);
+        }
+    }
+
+    void draw_all() {
+        graphics::ScopedDebugGroup debug_group("text::draw_all()");
+
+        for (Batch& batch : _batches) {
+            if (batch.vertices.empty()) continue;
+
+            //TODO: hide this logic in wrapper functions
+            const unsigned int vertices_byte_size = (unsigned int)batch.vertices.size() * sizeof(graphics::Vertex);
+            if (vertices_byte_size <= graphics::get_buffer_size(graphics::dynamic_vertex_buffer)) {
+                graphics::update_buffer(graphics::dynamic_vertex_buffer, batch.vertices.data(), vertices_byte_size);
+            } else {
+                graphics::recreate_buffer(graphics::dynamic_vertex_buffer, vertices_byte_size, batch.vertices.data());
+            }
+
+            // PITFALL: Recreating the buffer replaces the underlying API buffer, so it has to be bound again.
+            graphics::bind_vertex_buffer(0, graphics::dynamic_vertex_buffer, sizeof(graphics::Vertex));
+
+            // SDF atlases have to be sampled with linear filtering for the distance to interpolate.
+            const bool sdf = fonts::get_glyph_type(batch.font) == fonts::GlyphType::SDF &&
+                graphics::text_sdf_frag != Handle<graphics::FragmentShader>();
+            graphics::bind_vertex_shader(graphics::sprite_vert);
+            graphics::bind_fragment_shader(sdf ? graphics::text_sdf_frag : graphics::text_frag);
+            graphics::bind_texture(0, fonts::get_atlas_texture(batch.font));
+            if (sdf) {
+                graphics::bind_sampler(0, graphics::linear_sampler);
+            }
+            graphics::set_primitives(graphics::Primitives::TriangleList);
+            graphics::draw((unsigned int)batch.vertices.size());
+            if (sdf) {
+                graphics::bind_sampler(0, graphics::nearest_sampler);
+            }
+
+            batch.vertices.clear(); // Keep the batch and its capacity around for the next frame.
         }
 
-        graphics::bind_vertex_shader(graphics::sprite_vert);
-        graphics::bind_fragment_shader(graphics::text_frag);
-        graphics::bind_texture(0, fonts::get_atlas_texture(text.font));
-        graphics::update_buffer(graphics::dynamic_vertex_buffer,
-            vertices.data(), (unsigned int)vertices.size() * sizeof(graphics::Vertex));
-        graphics::set_primitives(graphics::Primitives::TriangleList);
-        graphics::draw((unsigned int)vertices.size());
+        std::erase_if(_layout_cache, [](const auto& pair) {
+            return _frame - pair.second.last_used_frame > _LAYOUT_CACHE_MAX_AGE;
+        });
+        ++_frame;
     }
-}
\ No newline at end of file
+}
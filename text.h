@@ -11,5 +11,9 @@ namespace text {
 		Vector2f scale = { 1.f, 1.f };
 	};
 
+	// Lays out the text and queues it to be drawn by draw_all(). Layouts are cached by font,
+	// string, pixel height and spacing, so rendering the same text every frame is cheap.
 	void render(const Text& text);
+	// Draws all text queued since the last call, using one draw call per font atlas.
+	void draw_all();
 }
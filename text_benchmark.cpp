@@ -0,0 +1,55 @@
+#include "stdafx.h"
+#ifdef _DEBUG
+#include "text_benchmark.h"
+#include "text.h"
+#include "fonts.h"
+#include "window.h"
+
+namespace text_benchmark {
+	const std::u32string _PARAGRAPH =
+		U"The quick brown fox jumps over the lazy dog. Sphinx of black quartz, judge my vow!\n"
+		U"Pack my box with five dozen liquor jugs. How vexingly quick daft zebras jump.\n"
+		U"AVATAR, WAVY, Type, Toyota, LT, \"quoted\" & (bracketed) - 0123456789 - \u00E5\u00E4\u00F6\u00E9\u00FC\u00DF.\n"
+		U"Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor.";
+
+	bool _enabled = false;
+	int _paragraphs_per_frame = 10;
+	float _smoothed_microseconds = 0.f;
+
+	void show_imgui_window() {
+#ifdef _DEBUG_IMGUI
+		ImGui::Begin("Text Benchmark");
+		ImGui::Checkbox("Enabled", &_enabled);
+		if (ImGui::InputInt("Paragraphs Per Frame", &_paragraphs_per_frame)) {
+			_paragraphs_per_frame = std::max(_paragraphs_per_frame, 0);
+		}
+		ImGui::Text("%.1f us per frame", _smoothed_microseconds);
+		if (_paragraphs_per_frame) {
+			ImGui::Text("%.2f us per paragraph", _smoothed_microseconds / _paragraphs_per_frame);
+		}
+		ImGui::End();
+#endif
+	}
+
+	void render(const Vector2f& position) {
+		if (!_enabled) return;
+
+		text::Text text{};
+		text.font = fonts::load_font("assets/fonts/Helvetica.ttf");
+		text.unicode_string = _PARAGRAPH;
+		text.pixel_height = 8.f;
+
+		const double start_time = window::get_elapsed_time();
+		for (int i = 0; i < _paragraphs_per_frame; ++i) {
+			text.position = position + Vector2f(0.f, 8.f * (float)(i % 4));
+			text::render(text);
+		}
+		const double end_time = window::get_elapsed_time();
+
+		constexpr float smoothing_factor = 0.95f;
+		const float microseconds = (float)((end_time - start_time) * 1'000'000.0);
+		_smoothed_microseconds = smoothing_factor * _smoothed_microseconds + (1.f - smoothing_factor) * microseconds;
+	}
+}
+
+#endif
@@ -0,0 +1,10 @@
+#pragma once
+#ifdef _DEBUG
+
+namespace text_benchmark {
+	void show_imgui_window();
+	// Renders a paragraph of text a number of times and measures how long it takes on the CPU.
+	void render(const Vector2f& position);
+}
+
+#endif
@@ -33,4 +33,8 @@ namespace tiled {
 
 	// Returns the map ID (an index into Context::maps[]), or UINT_MAX if not found.
 	unsigned int load_map_from_file(Context &context, const std::string& path);
+
+	// Parses the map again, even if it's already loaded. Tilesets and templates are not reloaded.
+	// Returns the map ID (an index into Context::maps[]), or UINT_MAX if the map failed to load.
+	unsigned int reload_map_from_file(Context &context, const std::string& path);
 }
@@ -199,6 +199,17 @@ namespace tiled {
 				Frame& frame = tile.animation.emplace_back();
 				frame.duration_ms = frame_node.attribute("duration").as_uint();
 				frame.tile_id = frame_node.attribute("tileid").as_uint();
+				tile.animation_duration_ms += frame.duration_ms;
+				frame.end_ms = tile.animation_duration_ms;
+			}
+			if (!tile.animation.empty()) {
+				tile.animation_frame_duration_ms = tile.animation.front().duration_ms;
+				for (const Frame& frame : tile.animation) {
+					if (frame.duration_ms != tile.animation_frame_duration_ms) {
+						tile.animation_frame_duration_ms = 0;
+						break;
+					}
+				}
 			}
 		}
 
@@ -494,21 +505,12 @@ namespace tiled {
 		}
 	}
 
-	unsigned int load_map_from_file(Context& context, const std::string& path) {
-		std::string normalized_path = _get_normalized_path(path);
-
-		// Check if the map is already loaded
-		for (unsigned int map_id = 0; map_id < context.maps.size(); ++map_id) {
-			if (context.maps[map_id].path == normalized_path) {
-				return map_id;
-			}
-		}
-
+	bool _load_map(Context& context, std::string&& normalized_path, Map& map) {
 		if (!context.file_load_callback) {
 			if (context.debug_message_callback) {
 				context.debug_message_callback("File load callback is not set: " + normalized_path);
 			}
-			return UINT_MAX;
+			return false;
 		}
 
 		std::string file_contents;
@@ -516,7 +518,7 @@ namespace tiled {
 			if (context.debug_message_callback) {
 				context.debug_message_callback("Failed to load Tiled map: " + normalized_path);
 			}
-			return UINT_MAX;
+			return false;
 		}
 
 		pugi::xml_document doc;
@@ -524,11 +526,11 @@ namespace tiled {
 			if (context.debug_message_callback) {
 				context.debug_message_callback("Failed to parse Tiled map: " + normalized_path);
 			}
-			return UINT_MAX;
+			return false;
 		}
 		pugi::xml_node map_node = doc.child("map");
 
-		Map map{};
+		map = {};
 		map.path = std::move(normalized_path);
 		map.class_ = map_node.attribute("class").as_string();
 		map.width = map_node.attribute("width").as_uint();
@@ -567,6 +569,38 @@ namespace tiled {
 			_load_layer_recursive(context, map, child_node);
 		}
 
+		return true;
+	}
+
+	unsigned int load_map_from_file(Context& context, const std::string& path) {
+		std::string normalized_path = _get_normalized_path(path);
+
+		// Check if the map is already loaded
+		for (unsigned int map_id = 0; map_id < context.maps.size(); ++map_id) {
+			if (context.maps[map_id].path == normalized_path) {
+				return map_id;
+			}
+		}
+
+		Map map{};
+		if (!_load_map(context, std::move(normalized_path), map)) return UINT_MAX;
+		const unsigned int map_id = (unsigned int)context.maps.size();
+		context.maps.emplace_back(std::move(map));
+		return map_id;
+	}
+
+	unsigned int reload_map_from_file(Context& context, const std::string& path) {
+		Map map{};
+		if (!_load_map(context, _get_normalized_path(path), map)) return UINT_MAX;
+
+		// Replace the map in place if it's already loaded, so its map ID stays the same.
+		for (unsigned int map_id = 0; map_id < context.maps.size(); ++map_id) {
+			if (context.maps[map_id].path == map.path) {
+				context.maps[map_id] = std::move(map);
+				return map_id;
+			}
+		}
+
 		const unsigned int map_id = (unsigned int)context.maps.size();
 		context.maps.emplace_back(std::move(map));
 		return map_id;
@@ -103,6 +103,7 @@ namespace tiled {
 
 	struct Frame {
 		unsigned int duration_ms = 0; // in milliseconds
+		unsigned int end_ms = 0; // in milliseconds; sum of duration_ms of this and all previous frames
 		unsigned int tile_id = 0; // index into Tileset::tiles[].
 	};
 
@@ -111,6 +112,8 @@ namespace tiled {
 		std::vector<Property> properties;
 		std::vector<Object>	objects;
 		std::vector<Frame> animation;
+		unsigned int animation_duration_ms = 0; // sum of duration_ms of all frames
+		unsigned int animation_frame_duration_ms = 0; // nonzero if and only if all frames have this same duration
 	};
 
 	struct WangColor {
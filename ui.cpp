@@ -42,6 +42,7 @@ namespace ui {
 	constexpr float _DT_ACCUMULATOR_MIN = 1.0f / 60.0f;
 	float _dt_accumulator = 0.f;
 	bool debug = false;
+	bool debug_clay = false;
 	RmlUiSystemInterface _system_interface;
 	RmlUiRenderInterface _render_interface;
 	Rml::Context* _context = nullptr;
@@ -340,7 +341,9 @@ namespace ui {
 
 		begin_clay_layout();
 
-		_test_clay();
+		if (debug_clay) {
+			_test_clay();
+		}
 		//TODO
 		end_clay_layout();
 
@@ -28,6 +28,7 @@ namespace ui {
 	}
 
 	extern bool debug;
+	extern bool debug_clay; // Shows the Clay test layout.
 
 	void initialize();
 	void shutdown();
@@ -1,9 +1,10 @@
 #include "stdafx.h"
 #include "ui.h"
 #include "console.h"
-#include "sprites.h"
 #include "graphics.h"
 #include "graphics_globals.h"
+#include "graphics_vertices.h"
+#include "fonts.h"
 
 #pragma warning(push)
 #pragma warning(disable: 4244) // conversion from '...' to '...', possible loss of data
@@ -26,9 +27,157 @@ namespace ui {
 		console::log_error(_clay_string_to_string_view(error_data.errorText));
 	}
 
+	// Measured text that hasn't been used for this many layouts is evicted from the cache.
+	constexpr uint64_t _MEASURE_TEXT_CACHE_MAX_AGE = 120;
+
+	struct MeasureTextKey {
+		uint64_t string_hash = 0;
+		uint16_t font_id = 0;
+		uint16_t font_size = 0;
+		uint16_t letter_spacing = 0;
+		uint16_t line_height = 0;
+
+		bool operator==(const MeasureTextKey&) const = default;
+	};
+
+	struct MeasureTextKeyHash {
+		size_t operator()(const MeasureTextKey& key) const {
+			return (size_t)(key.string_hash ^
+				((uint64_t)key.font_id << 48 | (uint64_t)key.font_size << 32 |
+				(uint64_t)key.letter_spacing << 16 | (uint64_t)key.line_height));
+		}
+	};
+
+	struct MeasuredText {
+		Clay_Dimensions dimensions{};
+		uint64_t last_used_layout = 0;
+	};
+
 	std::vector<uint8_t> _clay_arena_memory;
 	Clay_Arena _clay_arena{};
 	Clay_RenderCommandArray _clay_render_commands{};
+	std::vector<Handle<fonts::Font>> _clay_fonts; // indexed by Clay_TextElementConfig::fontId
+	std::unordered_map<MeasureTextKey, MeasuredText, MeasureTextKeyHash> _measure_text_cache;
+	uint64_t _clay_layout_count = 0;
+
+	// All Clay geometry is built into one vertex and index stream. Consecutive commands that share
+	// the same fragment shader, texture and scissor rectangle are merged into a single indexed draw.
+	struct ClayBatch {
+		Handle<graphics::FragmentShader> fragment_shader;
+		Handle<graphics::Texture> texture;
+		Handle<fonts::Font> font; // For text batches; the texture is the font's atlas, fetched when drawing.
+		Handle<graphics::Sampler> sampler;
+		bool scissor_test_enabled = false;
+		graphics::Rect scissor{};
+		unsigned int index_offset = 0;
+		unsigned int index_count = 0;
+	};
+
+	Handle<graphics::Buffer> _clay_vertex_buffer;
+	Handle<graphics::Buffer> _clay_index_buffer;
+	// Clay is drawn with the RmlUi shaders, so it needs its own pixel-to-clip-space transform.
+	Handle<graphics::Buffer> _clay_uniform_buffer;
+	std::vector<graphics::Vertex> _clay_vertices;
+	std::vector<unsigned int> _clay_indices;
+	std::vector<ClayBatch> _clay_batches;
+	bool _clay_scissor_test_enabled = false;
+	graphics::Rect _clay_scissor{};
+	// The hash of the render commands that the vertex and index buffers were last built from.
+	// If the next layout hashes the same, we skip rebuilding and uploading the geometry entirely.
+	uint64_t _clay_built_render_commands_hash = 0;
+	bool _clay_geometry_built = false;
+
+	uint64_t _hash_clay_string_slice(const Clay_StringSlice& text) {
+		// FNV-1a
+		uint64_t hash = 14695981039346656037ull;
+		for (int32_t i = 0; i < text.length; ++i) {
+			hash ^= (uint8_t)text.chars[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	// Decodes the UTF-8 codepoint starting at text[i] and advances i past it.
+	// Invalid or truncated sequences decode to U+FFFD.
+	char32_t _decode_utf8(const Clay_StringSlice& text, int32_t& i) {
+		const uint8_t lead = (uint8_t)text.chars[i++];
+		if (lead < 0x80) return lead;
+		int32_t continuation_count = 0;
+		char32_t codepoint = 0;
+		if ((lead & 0xE0) == 0xC0) {
+			continuation_count = 1;
+			codepoint = lead & 0x1F;
+		} else if ((lead & 0xF0) == 0xE0) {
+			continuation_count = 2;
+			codepoint = lead & 0x0F;
+		} else if ((lead & 0xF8) == 0xF0) {
+			continuation_count = 3;
+			codepoint = lead & 0x07;
+		} else {
+			return U'\uFFFD';
+		}
+		for (int32_t j = 0; j < continuation_count; ++j) {
+			if (i >= text.length || ((uint8_t)text.chars[i] & 0xC0) != 0x80) return U'\uFFFD';
+			codepoint = (codepoint << 6) | ((uint8_t)text.chars[i++] & 0x3F);
+		}
+		return codepoint;
+	}
+
+	Clay_Dimensions _measure_text_uncached(Clay_StringSlice text, const Clay_TextElementConfig& config) {
+		const Handle<fonts::Font> font = config.fontId < _clay_fonts.size() ? _clay_fonts[config.fontId] : Handle<fonts::Font>();
+		const float scale = fonts::get_scale_for_pixel_height(font, (float)config.fontSize);
+		if (scale == 0.f) {
+			// Unknown font, so fall back to a monospace estimate.
+			return { .width = (float)text.length * config.fontSize, .height = (float)config.fontSize };
+		}
+
+		// Clay splits text into words and lines before measuring, so we never see newlines here.
+		// letterSpacing is in pixels, while advances and kerning are in unscaled coordinates.
+		float width = 0.f; // In unscaled coordinates
+		uint32_t codepoint_count = 0;
+		char32_t previous_codepoint = 0;
+		for (int32_t i = 0; i < text.length;) {
+			const char32_t codepoint = _decode_utf8(text, i);
+			width += fonts::get_kerning_advance(font, previous_codepoint, codepoint);
+			width += fonts::get_glyph(font, codepoint).advance_width;
+			previous_codepoint = codepoint;
+			++codepoint_count;
+		}
+
+		return {
+			.width = width * scale + (float)codepoint_count * config.letterSpacing,
+			.height = config.lineHeight ? (float)config.lineHeight : fonts::get_line_spacing(font) * scale
+		};
+	}
+
+	Clay_Dimensions _measure_text(Clay_StringSlice text, Clay_TextElementConfig* config, void* user_data) {
+		const MeasureTextKey key{
+			.string_hash = _hash_clay_string_slice(text),
+			.font_id = config->fontId,
+			.font_size = config->fontSize,
+			.letter_spacing = config->letterSpacing,
+			.line_height = config->lineHeight
+		};
+		// PITFALL: Different strings with the same 64-bit hash will share a measurement.
+		auto [it, inserted] = _measure_text_cache.try_emplace(key);
+		if (inserted) {
+			it->second.dimensions = _measure_text_uncached(text, *config);
+		}
+		it->second.last_used_layout = _clay_layout_count;
+		return it->second.dimensions;
+	}
+
+	// Maps layout coordinates to clip space the same way as the RmlUi projection does.
+	graphics::UiUniformBlock _get_clay_uniform_block(float width, float height) {
+		graphics::UiUniformBlock block{};
+		block.transform[0] = 2.f / width;
+		block.transform[5] = 2.f / height;
+		block.transform[10] = -1.f;
+		block.transform[12] = -1.f;
+		block.transform[13] = -1.f;
+		block.transform[15] = 1.f;
+		return block;
+	}
 
 	bool initialize_clay() {
 		_clay_arena_memory.resize(Clay_MinMemorySize());
@@ -36,17 +185,52 @@ namespace ui {
 			(uint32_t)_clay_arena_memory.size(),
 			_clay_arena_memory.data()
 		);
-		return Clay_Initialize(
+		if (!Clay_Initialize(
 			_clay_arena, {
 				.width = GAME_FRAMEBUFFER_WIDTH,
 				.height = GAME_FRAMEBUFFER_HEIGHT,
 			}, {
 				.errorHandlerFunction = _handle_clay_errors,
 			}
-		);
+		)) return false;
+		Clay_SetMeasureTextFunction(_measure_text, nullptr);
+		_clay_vertex_buffer = graphics::create_buffer({
+			.debug_name = "clay vertex buffer",
+			.size = 1024 * sizeof(graphics::Vertex), // 1024 is an initial estimate
+			.type = graphics::BufferType::VertexBuffer,
+			.dynamic = true
+		});
+		_clay_index_buffer = graphics::create_buffer({
+			.debug_name = "clay index buffer",
+			.size = 1536 * sizeof(unsigned int), // 6 indices per 4 vertices
+			.type = graphics::BufferType::IndexBuffer,
+			.dynamic = true
+		});
+		const graphics::UiUniformBlock uniform_block = _get_clay_uniform_block(GAME_FRAMEBUFFER_WIDTH, GAME_FRAMEBUFFER_HEIGHT);
+		_clay_uniform_buffer = graphics::create_buffer({
+			.debug_name = "clay uniform buffer",
+			.size = sizeof(graphics::UiUniformBlock),
+			.type = graphics::BufferType::UniformBuffer,
+			.dynamic = true,
+			.initial_data = &uniform_block
+		});
+		add_clay_font(fonts::load_font("assets/fonts/Helvetica.ttf")); // CLAY_FONT_ID_DEFAULT
+		return true;
 	}
 
 	void shutdown_clay() {
+		graphics::destroy_buffer(_clay_vertex_buffer);
+		graphics::destroy_buffer(_clay_index_buffer);
+		graphics::destroy_buffer(_clay_uniform_buffer);
+		_clay_vertex_buffer = Handle<graphics::Buffer>();
+		_clay_index_buffer = Handle<graphics::Buffer>();
+		_clay_uniform_buffer = Handle<graphics::Buffer>();
+		_clay_vertices.clear();
+		_clay_indices.clear();
+		_clay_batches.clear();
+		_clay_geometry_built = false;
+		_measure_text_cache.clear();
+		_clay_fonts.clear();
 		_clay_render_commands = {};
 		_clay_arena = {};
 		_clay_arena_memory.clear();
@@ -54,6 +238,8 @@ namespace ui {
 
 	void set_clay_layout_dimensions(float width, float height) {
 		Clay_SetLayoutDimensions({ .width = width, .height = height });
+		const graphics::UiUniformBlock uniform_block = _get_clay_uniform_block(width, height);
+		graphics::update_buffer(_clay_uniform_buffer, &uniform_block, sizeof(uniform_block));
 	}
 
 	void set_clay_pointer_state(float x, float y, bool is_down) {
@@ -64,21 +250,17 @@ namespace ui {
 		Clay_UpdateScrollContainers(false, { .x = scroll_delta_x }, dt);
 	}
 
+	uint16_t add_clay_font(Handle<fonts::Font> font) {
+		_clay_fonts.push_back(font);
+		_measure_text_cache.clear(); // in case the font replaces a previously unknown font ID
+		return (uint16_t)(_clay_fonts.size() - 1);
+	}
+
 	void begin_clay_layout() {
 		_clay_render_commands = {};
 		Clay_BeginLayout();
 	}
 
-	// Example measure text function
-	static inline Clay_Dimensions MeasureText(Clay_StringSlice text, Clay_TextElementConfig* config, uintptr_t userData) {
-		// Clay_TextElementConfig contains members such as fontId, fontSize, letterSpacing etc
-		// Note: Clay_String->chars is not guaranteed to be null terminated
-		return {
-			.width = (float)text.length * config->fontSize, // <- this will only work for monospace fonts, see the renderers/ directory for more advanced text measurement
-				.height = (float)config->fontSize
-		};
-	}
-
 	// Layout config is just a struct that can be declared statically, or inline
 	Clay_ElementDeclaration sidebarItemConfig = {
 		.layout = {
@@ -186,55 +368,210 @@ namespace ui {
 
 	void end_clay_layout() {
 		_clay_render_commands = Clay_EndLayout();
+		std::erase_if(_measure_text_cache, [](const auto& pair) {
+			return _clay_layout_count - pair.second.last_used_layout > _MEASURE_TEXT_CACHE_MAX_AGE;
+		});
+		++_clay_layout_count;
 	}
 
-	void render_clay_layout() {
-		return;
-		if (!_clay_render_commands.length) return;
-		graphics::ScopedDebugGroup debug_group("ui::render_clay_layout()");
+	uint64_t _hash_bytes(uint64_t hash, const void* data, size_t size) {
+		// FNV-1a
+		for (size_t i = 0; i < size; ++i) {
+			hash ^= ((const uint8_t*)data)[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	// Hashes everything about the render commands that affects the generated geometry.
+	// PITFALL: We can't hash the render data unions wholesale, since the bytes
+	// past the end of the active member are uninitialized.
+	uint64_t _hash_clay_render_commands(const Clay_RenderCommandArray& commands) {
+		uint64_t hash = 14695981039346656037ull;
+		for (int32_t i = 0; i < commands.length; ++i) {
+			const Clay_RenderCommand& command = commands.internalArray[i];
+			hash = _hash_bytes(hash, &command.commandType, sizeof(command.commandType));
+			hash = _hash_bytes(hash, &command.boundingBox, sizeof(command.boundingBox));
+			switch (command.commandType) {
+			case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
+				const Clay_RectangleRenderData& rectangle = command.renderData.rectangle;
+				hash = _hash_bytes(hash, &rectangle.backgroundColor, sizeof(rectangle.backgroundColor));
+			} break;
+			case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+				const Clay_BorderRenderData& border = command.renderData.border;
+				hash = _hash_bytes(hash, &border.color, sizeof(border.color));
+				hash = _hash_bytes(hash, &border.width, sizeof(border.width));
+			} break;
+			case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+				const Clay_TextRenderData& text = command.renderData.text;
+				hash = _hash_bytes(hash, text.stringContents.chars, text.stringContents.length);
+				hash = _hash_bytes(hash, &text.textColor, sizeof(text.textColor));
+				hash = _hash_bytes(hash, &text.fontId, sizeof(text.fontId));
+				hash = _hash_bytes(hash, &text.fontSize, sizeof(text.fontSize));
+				hash = _hash_bytes(hash, &text.letterSpacing, sizeof(text.letterSpacing));
+				hash = _hash_bytes(hash, &text.lineHeight, sizeof(text.lineHeight));
+			} break;
+			case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+				const Clay_ImageRenderData& image = command.renderData.image;
+				hash = _hash_bytes(hash, &image.backgroundColor, sizeof(image.backgroundColor));
+				if (image.imageData) {
+					hash = _hash_bytes(hash, image.imageData, sizeof(Handle<graphics::Texture>));
+				}
+			} break;
+			}
+		}
+		return hash;
+	}
+
+	Color _clay_color_to_color(const Clay_Color& color) {
+		return {
+			(unsigned char)color.r,
+			(unsigned char)color.g,
+			(unsigned char)color.b,
+			(unsigned char)color.a
+		};
+	}
+
+	ClayBatch& _get_clay_batch(Handle<graphics::FragmentShader> fragment_shader, Handle<graphics::Texture> texture,
+		Handle<fonts::Font> font = Handle<fonts::Font>(), Handle<graphics::Sampler> sampler = graphics::nearest_sampler
+	) {
+		if (!_clay_batches.empty()) {
+			ClayBatch& current_batch = _clay_batches.back();
+			if (current_batch.fragment_shader == fragment_shader &&
+				current_batch.texture == texture &&
+				current_batch.font == font &&
+				current_batch.sampler == sampler &&
+				current_batch.scissor_test_enabled == _clay_scissor_test_enabled &&
+				(!_clay_scissor_test_enabled || memcmp(&current_batch.scissor, &_clay_scissor, sizeof(graphics::Rect)) == 0)
+			) {
+				return current_batch;
+			}
+		}
+		ClayBatch& new_batch = _clay_batches.emplace_back();
+		new_batch.fragment_shader = fragment_shader;
+		new_batch.texture = texture;
+		new_batch.font = font;
+		new_batch.sampler = sampler;
+		new_batch.scissor_test_enabled = _clay_scissor_test_enabled;
+		new_batch.scissor = _clay_scissor;
+		new_batch.index_offset = (unsigned int)_clay_indices.size();
+		return new_batch;
+	}
+
+	void _add_clay_quad(ClayBatch& batch, const Vector2f& pos0, const Vector2f& pos1, const Color& color,
+		const Vector2f& tex0 = { 0.f, 0.f }, const Vector2f& tex1 = { 1.f, 1.f }
+	) {
+		const unsigned int first_vertex = (unsigned int)_clay_vertices.size();
+		_clay_vertices.emplace_back(Vector2f(pos0.x, pos0.y), color, Vector2f(tex0.x, tex0.y));
+		_clay_vertices.emplace_back(Vector2f(pos1.x, pos0.y), color, Vector2f(tex1.x, tex0.y));
+		_clay_vertices.emplace_back(Vector2f(pos0.x, pos1.y), color, Vector2f(tex0.x, tex1.y));
+		_clay_vertices.emplace_back(Vector2f(pos1.x, pos1.y), color, Vector2f(tex1.x, tex1.y));
+		for (unsigned int index : { 0u, 1u, 2u, 2u, 1u, 3u }) {
+			_clay_indices.push_back(first_vertex + index);
+		}
+		batch.index_count += 6;
+	}
+
+	void _add_clay_rectangle(const Clay_BoundingBox& box, const Color& color) {
+		if (box.width <= 0.f || box.height <= 0.f) return;
+		ClayBatch& batch = _get_clay_batch(graphics::ui_frag, graphics::white_texture);
+		_add_clay_quad(batch, { box.x, box.y }, { box.x + box.width, box.y + box.height }, color);
+	}
+
+	void _add_clay_text(const Clay_BoundingBox& box, const Clay_TextRenderData& text) {
+		const Handle<fonts::Font> font = text.fontId < _clay_fonts.size() ? _clay_fonts[text.fontId] : Handle<fonts::Font>();
+		const float scale = fonts::get_scale_for_pixel_height(font, (float)text.fontSize);
+		if (scale == 0.f) return;
+
+		const bool sdf = fonts::get_glyph_type(font) == fonts::GlyphType::SDF &&
+			graphics::text_sdf_frag != Handle<graphics::FragmentShader>();
+		ClayBatch& batch = sdf
+			? _get_clay_batch(graphics::text_sdf_frag, Handle<graphics::Texture>(), font, graphics::linear_sampler)
+			: _get_clay_batch(graphics::text_frag, Handle<graphics::Texture>(), font);
+		const Color color = _clay_color_to_color(text.textColor);
+
+		// Clay emits one text command per line, with the bounding box sized to the line height.
+		const float line_height = fonts::get_line_spacing(font) * scale;
+		const float baseline_y = box.y + (box.height - line_height) / 2.f + fonts::get_ascent(font) * scale;
+		float pen_x = box.x;
+		char32_t previous_codepoint = 0;
+		for (int32_t i = 0; i < text.stringContents.length;) {
+			const char32_t codepoint = _decode_utf8(text.stringContents, i);
+			pen_x += fonts::get_kerning_advance(font, previous_codepoint, codepoint) * scale;
+			const fonts::Glyph glyph = fonts::get_glyph(font, codepoint);
+			if (glyph.s0 != glyph.s1 && glyph.t0 != glyph.t1) {
+				// PITFALL: The glyph box is y-up, while Clay's coordinates are y-down.
+				const Vector2f pos0 = { pen_x + glyph.x0 * scale, baseline_y - glyph.y1 * scale };
+				const Vector2f pos1 = { pen_x + glyph.x1 * scale, baseline_y - glyph.y0 * scale };
+				const Vector2f tex0 = Vector2f((float)glyph.s0, (float)glyph.t0) / (float)fonts::ATLAS_TEXTURE_SIZE;
+				const Vector2f tex1 = Vector2f((float)glyph.s1, (float)glyph.t1) / (float)fonts::ATLAS_TEXTURE_SIZE;
+				_add_clay_quad(batch, pos0, pos1, color, tex0, tex1);
+			}
+			pen_x += glyph.advance_width * scale + text.letterSpacing;
+			previous_codepoint = codepoint;
+		}
+	}
+
+	void _build_clay_geometry() {
+		_clay_vertices.clear();
+		_clay_indices.clear();
+		_clay_batches.clear();
+		_clay_scissor_test_enabled = false;
+		_clay_scissor = {};
+
 		for (int32_t i = 0; i < _clay_render_commands.length; ++i) {
 			const Clay_RenderCommand& command = _clay_render_commands.internalArray[i];
+			const Clay_BoundingBox& box = command.boundingBox;
 			switch (command.commandType) {
 			case CLAY_RENDER_COMMAND_TYPE_NONE: {
 				// This command type should be skipped.
 			} break;
 			case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
 				// The renderer should draw a solid color rectangle.
-				const Clay_RectangleRenderData& rectangle = command.renderData.rectangle;
-				sprites::Sprite sprite{};
-				sprite.vertex_shader = graphics::ui_rectangle_vert;
-				sprite.fragment_shader = graphics::ui_rectangle_frag;
-				sprite.position.x = command.boundingBox.x;
-				sprite.position.y = command.boundingBox.y;
-				sprite.size.x = command.boundingBox.width;
-				sprite.size.y = command.boundingBox.height;
-				sprite.color = {
-					(unsigned char)rectangle.backgroundColor.r,
-					(unsigned char)rectangle.backgroundColor.g,
-					(unsigned char)rectangle.backgroundColor.b,
-					(unsigned char)rectangle.backgroundColor.a
-				};
-				sprites::add(sprite);
+				//TODO: rounded corners
+				_add_clay_rectangle(box, _clay_color_to_color(command.renderData.rectangle.backgroundColor));
 			} break;
 			case CLAY_RENDER_COMMAND_TYPE_BORDER: {
 				// The renderer should draw a colored border inset into the bounding box.
-				__debugbreak();
+				const Clay_BorderRenderData& border = command.renderData.border;
+				const Color color = _clay_color_to_color(border.color);
+				const float left = border.width.left;
+				const float right = border.width.right;
+				const float top = border.width.top;
+				const float bottom = border.width.bottom;
+				_add_clay_rectangle({ box.x, box.y, box.width, top }, color);
+				_add_clay_rectangle({ box.x, box.y + box.height - bottom, box.width, bottom }, color);
+				_add_clay_rectangle({ box.x, box.y + top, left, box.height - top - bottom }, color);
+				_add_clay_rectangle({ box.x + box.width - right, box.y + top, right, box.height - top - bottom }, color);
 			} break;
 			case CLAY_RENDER_COMMAND_TYPE_TEXT: {
 				// The renderer should draw text.
-				__debugbreak();
+				_add_clay_text(box, command.renderData.text);
 			} break;
 			case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
 				// The renderer should draw an image.
-				//__debugbreak(); //TODO
+				const Clay_ImageRenderData& image = command.renderData.image;
+				if (!image.imageData) break;
+				const Handle<graphics::Texture> texture = *(const Handle<graphics::Texture>*)image.imageData;
+				// Clay defaults the tint to transparent black, which we treat as no tint.
+				const Clay_Color& tint = image.backgroundColor;
+				const Color color = (tint.r || tint.g || tint.b || tint.a) ? _clay_color_to_color(tint) : colors::WHITE;
+				ClayBatch& batch = _get_clay_batch(graphics::ui_frag, texture);
+				_add_clay_quad(batch, { box.x, box.y }, { box.x + box.width, box.y + box.height }, color);
 			} break;
 			case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
 				// The renderer should begin clipping all future draw commands, only rendering content that falls within the provided boundingBox.
-				__debugbreak();
+				_clay_scissor_test_enabled = true;
+				_clay_scissor = {
+					.x = (int)box.x,
+					.y = (int)box.y,
+					.width = (int)box.width,
+					.height = (int)box.height
+				};
 			} break;
 			case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
 				// The renderer should finish any previously active clipping, and begin rendering elements in full again.
-				__debugbreak();
+				_clay_scissor_test_enabled = false;
 			} break;
 			case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
 				// The renderer should provide a custom implementation for handling this render command based on its .customData
@@ -242,7 +579,60 @@ namespace ui {
 			} break;
 			}
 		}
+
+		//TODO: hide this logic in wrapper functions
+		const unsigned int vertices_byte_size = (unsigned int)_clay_vertices.size() * sizeof(graphics::Vertex);
+		if (vertices_byte_size <= graphics::get_buffer_size(_clay_vertex_buffer)) {
+			graphics::update_buffer(_clay_vertex_buffer, _clay_vertices.data(), vertices_byte_size);
+		} else {
+			graphics::recreate_buffer(_clay_vertex_buffer, vertices_byte_size, _clay_vertices.data());
+		}
+		const unsigned int indices_byte_size = (unsigned int)_clay_indices.size() * sizeof(unsigned int);
+		if (indices_byte_size <= graphics::get_buffer_size(_clay_index_buffer)) {
+			graphics::update_buffer(_clay_index_buffer, _clay_indices.data(), indices_byte_size);
+		} else {
+			graphics::recreate_buffer(_clay_index_buffer, indices_byte_size, _clay_indices.data());
+		}
+	}
+
+	void render_clay_layout() {
+		if (!_clay_render_commands.length) return;
+		graphics::ScopedDebugGroup debug_group("ui::render_clay_layout()");
+
+		const uint64_t render_commands_hash = _hash_clay_render_commands(_clay_render_commands);
+		if (!_clay_geometry_built || render_commands_hash != _clay_built_render_commands_hash) {
+			_build_clay_geometry();
+			_clay_built_render_commands_hash = render_commands_hash;
+			_clay_geometry_built = true;
+		}
+		if (_clay_batches.empty()) return;
+
+		graphics::Rect previous_scissor{};
+		graphics::get_scissor(previous_scissor);
+		const bool previous_scissor_test_enabled = graphics::get_scissor_test_enabled();
+
+		graphics::bind_vertex_shader(graphics::ui_vert);
+		graphics::bind_uniform_buffer(1, _clay_uniform_buffer);
+		graphics::bind_vertex_buffer(0, _clay_vertex_buffer, sizeof(graphics::Vertex));
+		graphics::bind_index_buffer(_clay_index_buffer);
+		graphics::set_primitives(graphics::Primitives::TriangleList);
+
 		// No need to sort, since the Clay render commands are already sorted.
-		sprites::draw();
+		for (const ClayBatch& batch : _clay_batches) {
+			graphics::set_scissor_test_enabled(batch.scissor_test_enabled);
+			if (batch.scissor_test_enabled) {
+				graphics::set_scissor(batch.scissor);
+			}
+			graphics::bind_fragment_shader(batch.fragment_shader);
+			graphics::bind_texture(0, batch.font != Handle<fonts::Font>() ? fonts::get_atlas_texture(batch.font) : batch.texture);
+			graphics::bind_sampler(0, batch.sampler);
+			graphics::draw_indexed(batch.index_count, batch.index_offset);
+		}
+
+		graphics::bind_sampler(0, graphics::nearest_sampler);
+		graphics::set_scissor_test_enabled(previous_scissor_test_enabled);
+		graphics::set_scissor(previous_scissor);
+		graphics::bind_vertex_buffer(0, graphics::dynamic_vertex_buffer, sizeof(graphics::Vertex));
+		graphics::bind_index_buffer(graphics::dynamic_index_buffer);
 	}
 }
\ No newline at end of file
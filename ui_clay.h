@@ -3,7 +3,13 @@
 // Clay (short for C Layout) is the 2D UI layout library we use in this project.
 // GitHub link: https://github.com/nicbarker/clay
 
+namespace fonts {
+	struct Font;
+}
+
 namespace ui {
+	const uint16_t CLAY_FONT_ID_DEFAULT = 0; // Helvetica
+
 	bool initialize_clay();
 	void shutdown_clay();
 
@@ -11,8 +17,13 @@ namespace ui {
 	void set_clay_pointer_state(float x, float y, bool is_down);
 	void update_clay_scroll_containers(float scroll_delta_x, float dt);
 
+	// Returns the font ID to use in Clay_TextElementConfig::fontId.
+	uint16_t add_clay_font(Handle<fonts::Font> font);
+
 	void begin_clay_layout();
 	void _test_clay();
 	void end_clay_layout();
+	// Draws the layout in as few indexed draws as possible, reusing last frame's geometry if the layout didn't change.
+	// Clay_ImageElementConfig::imageData is expected to point to a Handle<graphics::Texture>.
 	void render_clay_layout();
 }
\ No newline at end of file
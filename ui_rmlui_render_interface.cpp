@@ -1,8 +1,10 @@
 #include "stdafx.h"
+#include <bit>
 #include "ui_rmlui_render_interface.h"
 #include "graphics.h"
 #include "graphics_globals.h"
 #include "graphics_vertices.h"
+#include "pool.h"
 
 namespace ui {
 	static_assert(std::is_same_v<Rml::Matrix4f, Rml::ColumnMajorMatrix4f>);
@@ -25,6 +27,230 @@ namespace ui {
 		return *(Handle<graphics::Texture>*) & handle;
 	}
 
+	// RmlUi recompiles geometry whenever text or layout changes, so instead of creating two buffers
+	// per piece of geometry, we sub-allocate it from a few large vertex and index buffers ("pages").
+	// Each page keeps a free list of vertex ranges and index ranges, sorted by offset.
+
+	// Geometry released this many frames ago is assumed to no longer be in use by the GPU.
+	constexpr uint64_t _GEOMETRY_FREE_DELAY_FRAMES = 3;
+	constexpr unsigned int _GEOMETRY_PAGE_VERTEX_CAPACITY = 32768;
+	constexpr unsigned int _GEOMETRY_PAGE_INDEX_CAPACITY = 65536;
+
+	struct GeometryRange {
+		unsigned int offset = 0;
+		unsigned int count = 0;
+	};
+
+	struct GeometryPage {
+		Handle<graphics::Buffer> vertex_buffer;
+		Handle<graphics::Buffer> index_buffer;
+		std::vector<GeometryRange> free_vertex_ranges;
+		std::vector<GeometryRange> free_index_ranges;
+	};
+
+	struct CompiledGeometry {
+		unsigned int page_index = 0;
+		GeometryRange vertices;
+		GeometryRange indices;
+	};
+
+	struct PendingGeometryFree {
+		Handle<CompiledGeometry> handle;
+		uint64_t release_frame = 0;
+	};
+
+	std::vector<GeometryPage> _geometry_pages;
+	Pool<CompiledGeometry> _compiled_geometry_pool;
+	std::vector<PendingGeometryFree> _pending_geometry_frees;
+	uint64_t _render_frame = 0;
+	std::vector<graphics::Vertex> _compiled_vertices; // scratch space for converting Rml::Vertex
+
+	// Rml::Vertex has the layout of graphics::Vertex without the texture layer, so we can convert
+	// vertices by copying the Rml::Vertex part and leaving the layer at zero.
+	static_assert(offsetof(Rml::Vertex, position) == offsetof(graphics::Vertex, position));
+	static_assert(offsetof(Rml::Vertex, colour) == offsetof(graphics::Vertex, color));
+	static_assert(offsetof(Rml::Vertex, tex_coord) == offsetof(graphics::Vertex, tex_coord));
+	static_assert(sizeof(Rml::Vertex) <= offsetof(graphics::Vertex, tex_layer));
+
+	Rml::CompiledGeometryHandle _geometry_handle_to_rml(Handle<CompiledGeometry> handle) {
+		// PITFALL: 0 represents an invalid Rml::CompiledGeometryHandle,
+		// but valid handles never have generation 0, so this is fine.
+		return (Rml::CompiledGeometryHandle)std::bit_cast<uint32_t>(handle);
+	}
+
+	Handle<CompiledGeometry> _geometry_handle_from_rml(Rml::CompiledGeometryHandle handle) {
+		return std::bit_cast<Handle<CompiledGeometry>>((uint32_t)handle);
+	}
+
+	// First fit. Returns false if no free range is large enough.
+	bool _allocate_geometry_range(std::vector<GeometryRange>& free_ranges, unsigned int count, GeometryRange& range) {
+		if (!count) {
+			range = {};
+			return true;
+		}
+		for (auto it = free_ranges.begin(); it != free_ranges.end(); ++it) {
+			if (it->count < count) continue;
+			range = { it->offset, count };
+			it->offset += count;
+			it->count -= count;
+			if (!it->count) {
+				free_ranges.erase(it);
+			}
+			return true;
+		}
+		return false;
+	}
+
+	// Inserts the range back into the free list, merging it with adjacent free ranges.
+	void _free_geometry_range(std::vector<GeometryRange>& free_ranges, GeometryRange range) {
+		if (!range.count) return;
+		auto next = std::lower_bound(free_ranges.begin(), free_ranges.end(), range,
+			[](const GeometryRange& a, const GeometryRange& b) { return a.offset < b.offset; });
+		if (next != free_ranges.begin()) {
+			auto prev = std::prev(next);
+			if (prev->offset + prev->count == range.offset) {
+				prev->count += range.count;
+				if (next != free_ranges.end() && prev->offset + prev->count == next->offset) {
+					prev->count += next->count;
+					free_ranges.erase(next);
+				}
+				return;
+			}
+		}
+		if (next != free_ranges.end() && range.offset + range.count == next->offset) {
+			next->offset = range.offset;
+			next->count += range.count;
+			return;
+		}
+		free_ranges.insert(next, range);
+	}
+
+	unsigned int _create_geometry_page(unsigned int vertex_capacity, unsigned int index_capacity) {
+		GeometryPage& page = _geometry_pages.emplace_back();
+		page.vertex_buffer = graphics::create_buffer({
+			.debug_name = "rmlui vertex buffer",
+			.size = vertex_capacity * (unsigned int)sizeof(graphics::Vertex),
+			.type = graphics::BufferType::VertexBuffer,
+			.dynamic = true
+		});
+		page.index_buffer = graphics::create_buffer({
+			.debug_name = "rmlui index buffer",
+			.size = index_capacity * (unsigned int)sizeof(unsigned int),
+			.type = graphics::BufferType::IndexBuffer,
+			.dynamic = true
+		});
+		page.free_vertex_ranges.push_back({ 0, vertex_capacity });
+		page.free_index_ranges.push_back({ 0, index_capacity });
+		return (unsigned int)_geometry_pages.size() - 1;
+	}
+
+	bool _allocate_geometry(unsigned int vertex_count, unsigned int index_count, CompiledGeometry& geometry) {
+		for (unsigned int page_index = 0; page_index < _geometry_pages.size(); ++page_index) {
+			GeometryPage& page = _geometry_pages[page_index];
+			if (!_allocate_geometry_range(page.free_vertex_ranges, vertex_count, geometry.vertices)) continue;
+			if (!_allocate_geometry_range(page.free_index_ranges, index_count, geometry.indices)) {
+				_free_geometry_range(page.free_vertex_ranges, geometry.vertices);
+				continue;
+			}
+			geometry.page_index = page_index;
+			return true;
+		}
+		// No page has room, so create a new one that's at least large enough for this geometry.
+		const unsigned int page_index = _create_geometry_page(
+			std::max(vertex_count, _GEOMETRY_PAGE_VERTEX_CAPACITY),
+			std::max(index_count, _GEOMETRY_PAGE_INDEX_CAPACITY));
+		GeometryPage& page = _geometry_pages[page_index];
+		_allocate_geometry_range(page.free_vertex_ranges, vertex_count, geometry.vertices);
+		_allocate_geometry_range(page.free_index_ranges, index_count, geometry.indices);
+		geometry.page_index = page_index;
+		return true;
+	}
+
+	void _free_pending_geometry() {
+		std::erase_if(_pending_geometry_frees, [](const PendingGeometryFree& pending_free) {
+			if (_render_frame - pending_free.release_frame < _GEOMETRY_FREE_DELAY_FRAMES) return false;
+			if (const CompiledGeometry* geometry = _compiled_geometry_pool.get(pending_free.handle)) {
+				GeometryPage& page = _geometry_pages[geometry->page_index];
+				_free_geometry_range(page.free_vertex_ranges, geometry->vertices);
+				_free_geometry_range(page.free_index_ranges, geometry->indices);
+				_compiled_geometry_pool.free(pending_free.handle);
+			}
+			return true;
+		});
+	}
+
+	// Instead of updating one small uniform buffer before every draw, each draw's transform is written
+	// to its own slot in a per-frame ring. The draws are recorded and only submitted in
+	// restore_render_state(), after the whole ring has been uploaded in a single update.
+
+	// D3D11 binds constant buffer ranges in multiples of 16 shader constants, i.e. 256 bytes.
+	constexpr unsigned int _UI_UNIFORM_SLOT_SIZE = 256;
+
+	struct UiUniformSlot {
+		graphics::UiUniformBlock block;
+		unsigned char _padding[_UI_UNIFORM_SLOT_SIZE - sizeof(graphics::UiUniformBlock)] = {};
+	};
+
+	static_assert(sizeof(UiUniformSlot) == _UI_UNIFORM_SLOT_SIZE);
+
+	struct UiDrawCommand {
+		Handle<CompiledGeometry> geometry;
+		Handle<graphics::Texture> texture;
+		bool scissor_test_enabled = false;
+		graphics::Rect scissor{};
+	};
+
+	std::vector<UiUniformSlot> _ui_uniform_slots; // one per draw command
+	std::vector<UiDrawCommand> _ui_draw_commands;
+	// PITFALL: Draw commands recorded this frame may still reference a texture that RmlUi releases
+	// before they are submitted, so we delay destroying textures until the start of the next frame.
+	std::vector<Handle<graphics::Texture>> _pending_texture_destroys;
+	bool _scissor_test_enabled = false;
+	graphics::Rect _scissor{};
+
+	void _destroy_pending_textures() {
+		for (Handle<graphics::Texture> texture : _pending_texture_destroys) {
+			graphics::destroy_texture(texture);
+		}
+		_pending_texture_destroys.clear();
+	}
+
+	void _submit_draw_commands() {
+		if (_ui_draw_commands.empty()) return;
+
+		//TODO: hide this logic in wrapper functions
+		const unsigned int slots_byte_size = (unsigned int)(_ui_uniform_slots.size() * sizeof(UiUniformSlot));
+		if (slots_byte_size <= graphics::get_buffer_size(graphics::ui_uniform_buffer)) {
+			graphics::update_buffer(graphics::ui_uniform_buffer, _ui_uniform_slots.data(), slots_byte_size);
+		} else {
+			graphics::recreate_buffer(graphics::ui_uniform_buffer, slots_byte_size, _ui_uniform_slots.data());
+		}
+
+		unsigned int bound_geometry_page_index = UINT_MAX;
+		for (size_t i = 0; i < _ui_draw_commands.size(); ++i) {
+			const UiDrawCommand& command = _ui_draw_commands[i];
+			const CompiledGeometry* geometry = _compiled_geometry_pool.get(command.geometry);
+			if (!geometry) continue;
+			graphics::set_scissor_test_enabled(command.scissor_test_enabled);
+			if (command.scissor_test_enabled) {
+				graphics::set_scissor(command.scissor);
+			}
+			if (geometry->page_index != bound_geometry_page_index) {
+				const GeometryPage& page = _geometry_pages[geometry->page_index];
+				graphics::bind_vertex_buffer(0, page.vertex_buffer, sizeof(graphics::Vertex));
+				graphics::bind_index_buffer(page.index_buffer);
+				bound_geometry_page_index = geometry->page_index;
+			}
+			graphics::bind_uniform_buffer_range(1, graphics::ui_uniform_buffer,
+				_UI_UNIFORM_SLOT_SIZE, (unsigned int)i * _UI_UNIFORM_SLOT_SIZE);
+			graphics::bind_texture(0, command.texture);
+			graphics::draw_indexed(geometry->indices.count, geometry->indices.offset, geometry->vertices.offset);
+		}
+
+		_ui_uniform_slots.clear();
+		_ui_draw_commands.clear();
+	}
+
 	void set_viewport(int viewport_width, int viewport_height) {
 		_viewport_width = viewport_width;
 		_viewport_height = viewport_height;
@@ -40,11 +266,15 @@ namespace ui {
 		graphics::set_viewport({ .width = (float)_viewport_width, .height = (float)_viewport_height });
 		graphics::bind_vertex_shader(graphics::ui_vert);
 		graphics::bind_fragment_shader(graphics::ui_frag);
-		graphics::bind_uniform_buffer(1, graphics::ui_uniform_buffer);
 		graphics::set_primitives(graphics::Primitives::TriangleList);
+		_scissor_test_enabled = false;
+		_free_pending_geometry();
+		_destroy_pending_textures();
+		++_render_frame;
 	}
 
 	void restore_render_state() {
+		_submit_draw_commands();
 		graphics::set_viewport(_previous_viewport);
 		graphics::set_scissor_test_enabled(_previous_scissor_test_enabled);
 		graphics::set_scissor(_previous_scissor);
@@ -53,49 +283,40 @@ namespace ui {
 		graphics::pop_debug_group();
 	}
 
-	struct CompiledGeometry {
-		Handle<graphics::Buffer> vertex_buffer;
-		Handle<graphics::Buffer> index_buffer;
-		unsigned int index_count = 0;
-	};
-
 	Rml::CompiledGeometryHandle RmlUiRenderInterface::CompileGeometry(Rml::Span<const Rml::Vertex> vertices, Rml::Span<const int> indices) {
-		CompiledGeometry* compiled_geometry = new CompiledGeometry();
-		compiled_geometry->vertex_buffer = graphics::create_buffer({
-			.debug_name = "rmlui vertex buffer",
-			.size = (unsigned int)(sizeof(graphics::Vertex) * vertices.size()),
-			.type = graphics::BufferType::VertexBuffer,
-			.initial_data = vertices.data()
-		});
-		compiled_geometry->index_buffer = graphics::create_buffer({
-			.debug_name = "rmlui index buffer",
-			.size = (unsigned int)(sizeof(unsigned int) * indices.size()),
-			.type = graphics::BufferType::IndexBuffer,
-			.initial_data = indices.data()
-		});
-		compiled_geometry->index_count = (unsigned int)indices.size();
-		return (Rml::CompiledGeometryHandle)compiled_geometry;
+		CompiledGeometry geometry{};
+		if (!_allocate_geometry((unsigned int)vertices.size(), (unsigned int)indices.size(), geometry)) {
+			return Rml::CompiledGeometryHandle();
+		}
+		// PITFALL: The vertex buffers have the stride of graphics::Vertex, which is larger than Rml::Vertex.
+		_compiled_vertices.resize(vertices.size());
+		for (size_t i = 0; i < vertices.size(); ++i) {
+			memcpy(&_compiled_vertices[i], &vertices[i], sizeof(Rml::Vertex));
+		}
+		const GeometryPage& page = _geometry_pages[geometry.page_index];
+		// PITFALL: The allocated ranges may have been used by geometry that was released
+		// recently, which is why we delay freeing geometry by a few frames.
+		graphics::update_buffer_no_overwrite(page.vertex_buffer, _compiled_vertices.data(),
+			geometry.vertices.count * (unsigned int)sizeof(graphics::Vertex),
+			geometry.vertices.offset * (unsigned int)sizeof(graphics::Vertex));
+		graphics::update_buffer_no_overwrite(page.index_buffer, indices.data(),
+			geometry.indices.count * (unsigned int)sizeof(unsigned int),
+			geometry.indices.offset * (unsigned int)sizeof(unsigned int));
+		return _geometry_handle_to_rml(_compiled_geometry_pool.emplace(geometry));
 	}
 
 	void RmlUiRenderInterface::RenderGeometry(Rml::CompiledGeometryHandle geometry, Rml::Vector2f translation, Rml::TextureHandle texture) {
-		CompiledGeometry* compiled_geometry = (CompiledGeometry *)geometry;
-		graphics::bind_vertex_buffer(0, compiled_geometry->vertex_buffer, sizeof(graphics::Vertex));
-		graphics::bind_index_buffer(compiled_geometry->index_buffer);
+		UiDrawCommand& command = _ui_draw_commands.emplace_back();
+		command.geometry = _geometry_handle_from_rml(geometry);
+		command.texture = texture ? _texture_handle_from_rml(texture) : graphics::white_texture;
+		command.scissor_test_enabled = _scissor_test_enabled;
+		command.scissor = _scissor;
 		const Rml::Matrix4f transform = _view_proj_matrix * _transform * Rml::Matrix4f::Translate(translation.x, translation.y, 0.0f);
-		graphics::update_buffer(graphics::ui_uniform_buffer, transform.data(), sizeof(Rml::Matrix4f));
-		if (texture) {
-			graphics::bind_texture(0, _texture_handle_from_rml(texture));
-		} else {
-			graphics::bind_texture(0, graphics::white_texture);
-		}
-		graphics::draw_indexed(compiled_geometry->index_count);
+		memcpy(_ui_uniform_slots.emplace_back().block.transform, transform.data(), sizeof(Rml::Matrix4f));
 	}
 
 	void RmlUiRenderInterface::ReleaseGeometry(Rml::CompiledGeometryHandle geometry) {
-		CompiledGeometry* compiled_geometry = (CompiledGeometry*)geometry;
-		graphics::destroy_buffer(compiled_geometry->vertex_buffer);
-		graphics::destroy_buffer(compiled_geometry->index_buffer);
-		delete compiled_geometry;
+		_pending_geometry_frees.push_back({ _geometry_handle_from_rml(geometry), _render_frame });
 	}
 
 	Rml::TextureHandle RmlUiRenderInterface::LoadTexture(Rml::Vector2i& texture_dimensions, const Rml::String& source) {
@@ -122,20 +343,20 @@ namespace ui {
 	}
 
 	void RmlUiRenderInterface::ReleaseTexture(Rml::TextureHandle texture_handle) {
-		graphics::destroy_texture(_texture_handle_from_rml(texture_handle));
+		_pending_texture_destroys.push_back(_texture_handle_from_rml(texture_handle));
 	}
 
 	void RmlUiRenderInterface::EnableScissorRegion(bool enable) {
-		graphics::set_scissor_test_enabled(enable);
+		_scissor_test_enabled = enable;
 	}
 
 	void RmlUiRenderInterface::SetScissorRegion(Rml::Rectanglei region) {
-		graphics::set_scissor({
+		_scissor = graphics::Rect{
 			.x = region.Left(),
 			.y = region.Top(),
 			.width = region.Width(),
 			.height = region.Height()
-		});
+		};
 	}
 
 	void RmlUiRenderInterface::SetTransform(const Rml::Matrix4f* transform) {
@@ -47,10 +47,17 @@ namespace ui {
 
 	extern Rml::Context* _context;
 	TextboxEventListener _textbox_event_listener;
-	std::optional<Textbox> _textbox;
-	std::deque<Textbox> _textbox_queue;
+	std::optional<CompiledTextbox> _textbox;
+	std::deque<CompiledTextbox> _textbox_queue;
+	std::deque<Textbox> _textbox_ad_hoc_storage; // owns the strings of textboxes that aren't presets
+	std::deque<std::vector<std::string_view>> _textbox_ad_hoc_options; // owns the option views of those textboxes
+	bool _textbox_options_bound = false; // whether bindings::textbox_options holds the current options
 	float _textbox_typing_time = 0.f; // time since last character was typed
 	size_t _textbox_typing_counter = 0; // number of characters typed
+	std::vector<size_t> _textbox_plain_offsets; // offsets into Textbox::text of the plain text characters
+	std::string _textbox_hidden_text; // Textbox::text with all graphical plain text hidden
+	std::vector<size_t> _textbox_hidden_offsets; // offsets into _textbox_hidden_text of the plain text characters
+	size_t _textbox_typed_text_counter = SIZE_MAX; // value of _textbox_typing_counter when bindings::textbox_text was last set
 
 	void _on_textbox_keydown_c() {
 		if (!_textbox) return;
@@ -80,55 +87,51 @@ namespace ui {
 		}
 	}
 
-	// Returns true if the character at pos is plain text,
-	// defined as a character that is not part of an RML tag.
-	bool _is_plain(const std::string& rml, size_t pos) {
-		for (size_t i = pos; i < rml.size(); ++i) {
-			if (rml[i] == '<') return i != pos;
-			if (rml[i] == '>') return false;
-		}
-		return true;
-	}
+	// Plain text is defined as characters that are not part of an RML tag.
+	// When a textbox is opened, we locate all plain text characters once, so that
+	// typing them out doesn't require re-scanning the RML every frame.
+	void _build_textbox_typing_table(std::string_view rml) {
+		_textbox_plain_offsets.clear();
+		_textbox_hidden_text.clear();
+		_textbox_hidden_offsets.clear();
 
-	// Counts the number of plain text characters in the string.
-	size_t _get_plain_count(const std::string& rml) {
-		size_t count = 0;
-		for (size_t i = 0; i < rml.size(); ++i) {
-			if (_is_plain(rml, i)) {
-				++count;
+		// A character is plain unless it is a '<' or '>', or the next '<' or '>' after it is a '>'.
+		// We find the plain characters by scanning backwards, keeping track of the next bracket.
+		std::vector<bool> is_plain(rml.size());
+		char next_bracket = '\0';
+		for (size_t i = rml.size(); i-- > 0;) {
+			if (rml[i] == '<' || rml[i] == '>') {
+				next_bracket = rml[i];
+			} else {
+				is_plain[i] = (next_bracket != '>');
 			}
 		}
-		return count;
-	}
 
-	// Returns the nth plain text character if n < _get_plain_length(rml), or '\0' otherwise.
-	char _get_nth_plain(const std::string& rml, size_t n) {
-		size_t count = 0;
+		// The hidden text replaces graphical plain text with non-breaking spaces.
+		// This is used to prevent the text from jumping around when being typed out.
 		for (size_t i = 0; i < rml.size(); ++i) {
-			if (_is_plain(rml, i)) {
-				if (count == n) return rml[i];
-				++count;
+			if (is_plain[i]) {
+				_textbox_plain_offsets.push_back(i);
+				_textbox_hidden_offsets.push_back(_textbox_hidden_text.size());
+			}
+			if (is_plain[i] && isgraph((unsigned char)rml[i])) {
+				_textbox_hidden_text += "&nbsp;";
+			} else {
+				_textbox_hidden_text += rml[i];
 			}
 		}
-		return '\0';
 	}
 
-	// Replaces graphical plain text with non-breaking spaces, starting at offset.
-	// This is used to prevent the text from jumping around when being typed out.
-	std::string _replace_graphical_plain_with_nbsp(const std::string& rml, size_t offset) {
-		std::string ret;
-		size_t count = 0;
-		for (size_t i = 0; i < rml.size(); ++i) {
-			bool replace = false;
-			if (_is_plain(rml, i)) {
-				if (count >= offset && isgraph(rml[i])) {
-					replace = true;
-				}
-				++count;
-			}
-			ret += replace ? "&nbsp;" : rml.substr(i, 1);
+	// Returns the RML with the first typed_count plain text characters shown, and the rest hidden.
+	void _get_partially_typed_text(std::string_view rml, size_t typed_count, std::string& typed_text) {
+		if (typed_count >= _textbox_plain_offsets.size()) {
+			typed_text = rml;
+			return;
 		}
-		return ret;
+		// Everything before the next plain character to type is shown as-is,
+		// and everything from it onwards is taken from the hidden text.
+		typed_text.assign(rml.substr(0, _textbox_plain_offsets[typed_count]));
+		typed_text.append(_textbox_hidden_text, _textbox_hidden_offsets[typed_count]);
 	}
 
 	Rml::ElementDocument* _get_textbox_document() {
@@ -144,15 +147,14 @@ namespace ui {
 	void update_textbox(float dt) {
 		if (!_textbox) return;
 
-		size_t plain_count = _get_plain_count(_textbox->text);
+		const size_t plain_count = _textbox_plain_offsets.size();
 		if (_textbox_typing_counter < plain_count && _textbox->typing_speed > 0.f) {
 			float seconds_per_char = 1.f / _textbox->typing_speed;
 			_textbox_typing_time += dt;
 			if (_textbox_typing_time >= seconds_per_char) {
 				_textbox_typing_time -= seconds_per_char;
-				if (isgraph(_get_nth_plain(_textbox->text, _textbox_typing_counter))) {
-					std::string path = "event:/" + _textbox->typing_sound;
-					audio::create_event({ .path = path.c_str() });
+				if (isgraph((unsigned char)_textbox->text[_textbox_plain_offsets[_textbox_typing_counter]])) {
+					audio::create_event({ .id = _textbox->typing_sound });
 				}
 				++_textbox_typing_counter;
 			}
@@ -162,17 +164,23 @@ namespace ui {
 
 		const bool finished_typing = (_textbox_typing_counter == plain_count);
 
-		bindings::textbox_text = _replace_graphical_plain_with_nbsp(
-			_textbox->text, _textbox_typing_counter);
+		if (_textbox_typed_text_counter != _textbox_typing_counter) {
+			_get_partially_typed_text(_textbox->text, _textbox_typing_counter, bindings::textbox_text);
+			_textbox_typed_text_counter = _textbox_typing_counter;
+		}
 		bindings::textbox_has_sprite = (_textbox->sprite != TextboxSprite::None);
 		bindings::textbox_sprite = get_textbox_sprite_name(_textbox->sprite);
 		if (finished_typing) {
-			bindings::textbox_has_options = !_textbox->options.empty();
-			bindings::textbox_options = _textbox->options;
+			if (!_textbox_options_bound) {
+				bindings::textbox_has_options = !_textbox->options.empty();
+				bindings::textbox_options.assign(_textbox->options.begin(), _textbox->options.end());
+				_textbox_options_bound = true;
+			}
 		} else {
 			bindings::textbox_has_options = false;
 			bindings::textbox_options.clear();
 			bindings::textbox_selected_option = 0;
+			_textbox_options_bound = false;
 		}
 	}
 
@@ -188,35 +196,65 @@ namespace ui {
 
 	bool is_textbox_typing() {
 		if (!_textbox) return false;
-		return _textbox_typing_counter < _get_plain_count(_textbox->text);
+		return _textbox_typing_counter < _textbox_plain_offsets.size();
 	}
 
 	void skip_textbox_typing() {
 		if (!_textbox) return;
-		_textbox_typing_counter = _get_plain_count(_textbox->text);
+		_textbox_typing_counter = _textbox_plain_offsets.size();
 	}
 
-	void open_textbox(const Textbox& textbox) {
+	audio::EventId _get_textbox_sound_event_id(const std::string& sound);
+
+	// Copies the strings of a textbox that isn't a preset into storage that lives
+	// until the textbox queue runs empty, and returns a compiled view of it.
+	CompiledTextbox _compile_ad_hoc_textbox(const Textbox& textbox) {
+		const Textbox& stored = _textbox_ad_hoc_storage.emplace_back(textbox);
+		std::vector<std::string_view>& options = _textbox_ad_hoc_options.emplace_back(
+			stored.options.begin(), stored.options.end());
+		return CompiledTextbox{
+			.path = stored.path,
+			.text = stored.text,
+			.sprite = stored.sprite,
+			.opening_sound = _get_textbox_sound_event_id(stored.opening_sound),
+			.typing_sound = _get_textbox_sound_event_id(stored.typing_sound),
+			.typing_speed = stored.typing_speed,
+			.options = options,
+			.options_callback = stored.options_callback,
+		};
+	}
+
+	void _open_textbox(const CompiledTextbox& textbox) {
 		_textbox = textbox;
 		_textbox_typing_time = 0.f;
 		_textbox_typing_counter = 0;
-		if (!_textbox->opening_sound.empty()) {
-			std::string path = "event:/" + _textbox->opening_sound;
-			audio::create_event({ .path = path.c_str() });
+		_textbox_typed_text_counter = SIZE_MAX;
+		_textbox_options_bound = false;
+		_build_textbox_typing_table(_textbox->text);
+		if (_textbox->opening_sound != audio::EventId::None) {
+			audio::create_event({ .id = _textbox->opening_sound });
 		}
 		_set_textbox_document_visible(true);
 	}
 
+	void _open_or_enqueue_textbox(const CompiledTextbox& textbox) {
+		if (is_textbox_open()) {
+			_textbox_queue.push_back(textbox);
+		} else {
+			_open_textbox(textbox);
+		}
+	}
+
+	void open_textbox(const Textbox& textbox) {
+		_open_textbox(_compile_ad_hoc_textbox(textbox));
+	}
+
 	void enqueue_textbox(const Textbox& textbox) {
-		_textbox_queue.push_back(textbox);
+		_textbox_queue.push_back(_compile_ad_hoc_textbox(textbox));
 	}
 
 	void open_or_enqueue_textbox(const Textbox& textbox) {
-		if (is_textbox_open()) {
-			enqueue_textbox(textbox);
-		} else {
-			open_textbox(textbox);
-		}
+		_open_or_enqueue_textbox(_compile_ad_hoc_textbox(textbox));
 	}
 
 	bool open_next_textbox_in_queue() {
@@ -224,34 +262,41 @@ namespace ui {
 			close_textbox();
 			return false;
 		}
-		open_textbox(_textbox_queue.front());
+		_open_textbox(_textbox_queue.front());
 		_textbox_queue.pop_front();
 		return true;
 	}
 
 	void close_textbox() {
 		_textbox.reset();
+		_textbox_typed_text_counter = SIZE_MAX;
+		_textbox_options_bound = false;
 		bindings::_clear_textbox_bindings();
 		_set_textbox_document_visible(false);
+		if (_textbox_queue.empty()) {
+			// Nothing refers to the ad-hoc textboxes anymore.
+			_textbox_ad_hoc_storage.clear();
+			_textbox_ad_hoc_options.clear();
+		}
 	}
 
 	void close_textbox_and_clear_queue() {
-		close_textbox();
 		_textbox_queue.clear();
+		close_textbox();
 	}
 
-	void open_or_enqueue_textbox_presets(const std::string& path) {
-		for (const Textbox& textbox : get_textbox_presets(path)) {
-			open_or_enqueue_textbox(textbox);
+	void open_or_enqueue_textbox_presets(std::string_view path) {
+		for (const CompiledTextbox& textbox : get_textbox_presets(path)) {
+			_open_or_enqueue_textbox(textbox);
 		}
 	}
 
 	void show_textbox_debug_window() {
 #ifdef _DEBUG_IMGUI
 		ImGui::Begin("Textbox");
-		for (const Textbox& textbox : get_textbox_presets()) {
-			if (ImGui::Button(textbox.path.c_str())) {
-				open_or_enqueue_textbox(textbox);
+		for (const CompiledTextbox& textbox : get_textbox_presets()) {
+			if (ImGui::Button(textbox.path.data())) {
+				_open_or_enqueue_textbox(textbox);
 			}
 		}
 		ImGui::End();
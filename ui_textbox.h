@@ -1,4 +1,5 @@
 #pragma once
+#include "audio.h"
 
 namespace ui {
 	enum class TextboxSprite {
@@ -23,6 +24,19 @@ namespace ui {
 		void (*options_callback)(const std::string& option) = nullptr;
 	};
 
+	// A textbox compiled for playback. The strings are views into storage owned by the textbox module,
+	// and sound names are resolved to event IDs, so opening or queueing one doesn't allocate.
+	struct CompiledTextbox {
+		std::string_view path;
+		std::string_view text; // RML
+		TextboxSprite sprite = TextboxSprite::None;
+		audio::EventId opening_sound = audio::EventId::None;
+		audio::EventId typing_sound = audio::EventId::None;
+		float typing_speed = 25.f; // in chars per second, 0 = instant
+		std::span<const std::string_view> options;
+		void (*options_callback)(const std::string& option) = nullptr;
+	};
+
 	void add_textbox_event_listeners();
 	void create_textbox_presets();
 	void update_textbox(float dt);
@@ -50,11 +64,14 @@ namespace ui {
 
 	// PRESETS
 
-	// Returns a list of all textbox presets, sorted lexicographically by Textbox::path.
-	std::span<const Textbox> get_textbox_presets();
+	// The presets are compiled once by create_textbox_presets() into an immutable table,
+	// so the returned spans stay valid until the presets are created again.
+
+	// Returns a list of all textbox presets, sorted lexicographically by CompiledTextbox::path.
+	std::span<const CompiledTextbox> get_textbox_presets();
 	// Returns a list of all textbox presets whose path starts with the given path.
-	std::span<const Textbox> get_textbox_presets(const std::string& path);
-	void open_or_enqueue_textbox_presets(const std::string& path);
+	std::span<const CompiledTextbox> get_textbox_presets(std::string_view path);
+	void open_or_enqueue_textbox_presets(std::string_view path);
 
 	// DEBUGGING
 
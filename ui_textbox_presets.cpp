@@ -18,35 +18,84 @@ namespace ui
 	const std::string Textbox::OPENING_SOUND_ITEM_FANFARE = "snd_item_fanfare";
 	const std::string Textbox::DEFAULT_TYPING_SOUND = "snd_txt1";
 
-	std::vector<Textbox> _textbox_presets;
+	std::unordered_set<std::string> _textbox_preset_strings; // interned strings, node-based so views stay valid
+	std::vector<std::string_view> _textbox_preset_options; // options of all presets, in preset order
+	std::vector<CompiledTextbox> _textbox_presets; // sorted by path
 
-	std::span<const Textbox> get_textbox_presets()
+	std::string_view _intern_textbox_preset_string(std::string&& str)
+	{
+		if (str.empty()) return {};
+		return *_textbox_preset_strings.insert(std::move(str)).first;
+	}
+
+	audio::EventId _get_textbox_sound_event_id(const std::string& sound)
+	{
+		if (sound.empty()) return audio::EventId::None;
+		return audio::get_event_id("event:/" + sound);
+	}
+
+	void _compile_textbox_presets(std::vector<Textbox>& presets)
+	{
+		std::sort(presets.begin(), presets.end(),
+			[](const Textbox& left, const Textbox& right) { return left.path < right.path; });
+
+		size_t option_count = 0;
+		for (const Textbox& preset : presets) {
+			option_count += preset.options.size();
+		}
+
+		// PITFALL: The option spans point into _textbox_preset_options,
+		// so it must not reallocate while we are filling it.
+		_textbox_preset_options.reserve(option_count);
+		_textbox_presets.reserve(presets.size());
+		for (Textbox& preset : presets) {
+			const size_t first_option = _textbox_preset_options.size();
+			for (std::string& option : preset.options) {
+				_textbox_preset_options.push_back(_intern_textbox_preset_string(std::move(option)));
+			}
+			CompiledTextbox& compiled = _textbox_presets.emplace_back();
+			compiled.path = _intern_textbox_preset_string(std::move(preset.path));
+			compiled.text = _intern_textbox_preset_string(std::move(preset.text));
+			compiled.sprite = preset.sprite;
+			compiled.opening_sound = _get_textbox_sound_event_id(preset.opening_sound);
+			compiled.typing_sound = _get_textbox_sound_event_id(preset.typing_sound);
+			compiled.typing_speed = preset.typing_speed;
+			compiled.options = std::span(_textbox_preset_options).subspan(first_option, preset.options.size());
+			compiled.options_callback = preset.options_callback;
+		}
+	}
+
+	std::span<const CompiledTextbox> get_textbox_presets()
 	{
 		return _textbox_presets;
 	}
 
-	std::span<const Textbox> get_textbox_presets(const std::string& path)
+	std::span<const CompiledTextbox> get_textbox_presets(std::string_view path)
 	{
-		const size_t path_size = path.size();
-		auto [first, last] = std::equal_range(_textbox_presets.begin(), _textbox_presets.end(), Textbox{ path },
-			[path_size](const Textbox& left, const Textbox& right) {
-				return strncmp(left.path.c_str(), right.path.c_str(), path_size) < 0;
-			});
+		// Since the presets are sorted by path, all paths starting with the given prefix form a contiguous range.
+		auto first = std::lower_bound(_textbox_presets.begin(), _textbox_presets.end(), path,
+			[](const CompiledTextbox& preset, std::string_view path) { return preset.path < path; });
+		auto last = std::find_if_not(first, _textbox_presets.end(),
+			[path](const CompiledTextbox& preset) { return preset.path.starts_with(path); });
 		return { first, last };
 	}
 
 	void create_textbox_presets()
 	{
 		_textbox_presets.clear();
+		_textbox_preset_options.clear();
+		_textbox_preset_strings.clear();
+
+		std::vector<Textbox> presets;
 
 		{
-			Textbox& tb = _textbox_presets.emplace_back();
+			Textbox& tb = presets.emplace_back();
 			tb.path = "player/die/0";
 			tb.text = "You are <span style='color: red'>deader than dead</span>!<br/>Oh, what a pity that your adventure should end here, and so soon...";
 			tb.sprite = TextboxSprite::Skull;
 		}
 		{
-			Textbox& tb = _textbox_presets.emplace_back();
+			Textbox& tb = presets.emplace_back();
 			tb.path = "player/die/1";
 			tb.text = "Would you like to try again?";
 			tb.options = { "Yes", "No" };
@@ -59,7 +108,6 @@ namespace ui
 			};
 		}
 
-		std::sort(_textbox_presets.begin(), _textbox_presets.end(),
-			[](const Textbox& left, const Textbox& right) { return left.path < right.path; });
+		_compile_textbox_presets(presets);
 	}
 }
\ No newline at end of file